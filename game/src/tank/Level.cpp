@@ -13,6 +13,7 @@
 #include "DefaultCamera.h"
 
 #include "core/debug.h"
+#include "core/Profiler.h"
 
 #include "config/Config.h"
 #include "config/Language.h"
@@ -37,6 +38,7 @@
 #include "gc/Player.h"
 #include "gc/Sound.h"
 #include "gc/Camera.h"
+#include "gc/Vehicle.h"
 
 //#ifdef _DEBUG
 #include "gc/ai.h"
@@ -44,17 +46,58 @@
 
 ////////////////////////////////////////////////////////////
 
-unsigned long FieldCell::_sessionId;
+PROFILE_TAG(tagStep, "Level::Step");
+PROFILE_TAG(tagResponse, "ProcessResponse");
+PROFILE_TAG(tagCmdQueue, "RunCmdQueue");
+PROFILE_TAG(tagRender, "RenderInternal");
 
-void FieldCell::UpdateProperties()
+////////////////////////////////////////////////////////////
+
+MemoryPool<FieldCell::Chunk> FieldCell::_chunkPool;
+
+FieldCell::FieldCell()
+  : _chunks(NULL)
+  , _objCount(0)
 {
-	_prop = 0;
+}
+
+FieldCell::~FieldCell()
+{
+	while( _chunks )
+	{
+		Chunk *next = _chunks->next;
+		_chunkPool.Free(_chunks);
+		_chunks = next;
+	}
+}
+
+GC_RigidBodyStatic*& FieldCell::Slot(int index)
+{
+	if( index < INLINE_COUNT )
+		return _inline[index];
+	Chunk *chunk = _chunks;
+	for( index -= INLINE_COUNT; index >= CHUNK_SIZE; index -= CHUNK_SIZE )
+		chunk = chunk->next;
+	return chunk->objects[index];
+}
+
+GC_RigidBodyStatic* FieldCell::GetObject(int index) const
+{
+	assert(index >= 0 && index < _objCount);
+	return const_cast<FieldCell *>(this)->Slot(index);
+}
+
+unsigned char FieldCell::CalcPassability() const
+{
+	unsigned char result = 0;
 	for( int i = 0; i < _objCount; i++ )
 	{
-		assert(_ppObjects[i]->GetPassability() > 0);
-		if( _ppObjects[i]->GetPassability() > _prop )
-			_prop = _ppObjects[i]->GetPassability();
+		GC_RigidBodyStatic *object = GetObject(i);
+		assert(object->GetPassability() > 0);
+		if( object->GetPassability() > result )
+			result = object->GetPassability();
 	}
+	return result;
 }
 
 void FieldCell::AddObject(GC_RigidBodyStatic *object)
@@ -65,23 +108,24 @@ void FieldCell::AddObject(GC_RigidBodyStatic *object)
 #ifdef _DEBUG
 	for( int i = 0; i < _objCount; ++i )
 	{
-		assert(object != _ppObjects[i]);
+		assert(object != GetObject(i));
 	}
 #endif
 
-	GC_RigidBodyStatic **tmp = new GC_RigidBodyStatic* [_objCount + 1];
-
-	if( _ppObjects )
+	int index = _objCount;
+	if( index >= INLINE_COUNT && 0 == (index - INLINE_COUNT) % CHUNK_SIZE )
 	{
-		assert(_objCount > 0);
-		memcpy(tmp, _ppObjects, sizeof(GC_RigidBodyStatic*) * _objCount);
-		delete[] _ppObjects;
+		// all chunks are full; append a new one
+		Chunk *chunk = new (_chunkPool.Alloc()) Chunk;
+		chunk->next = NULL;
+		Chunk **tail = &_chunks;
+		while( *tail )
+			tail = &(*tail)->next;
+		*tail = chunk;
 	}
 
-	_ppObjects = tmp;
-	_ppObjects[_objCount++] = object;
-
-	UpdateProperties();
+	++_objCount;
+	Slot(index) = object;
 }
 
 void FieldCell::RemoveObject(GC_RigidBodyStatic *object)
@@ -89,42 +133,39 @@ void FieldCell::RemoveObject(GC_RigidBodyStatic *object)
 	assert(object);
 	assert(_objCount > 0);
 
-	if( 1 == _objCount )
+	// keep the order of the remaining objects
+	int i = 0;
+	while( GetObject(i) != object )
 	{
-		assert(object == _ppObjects[0]);
-		_objCount = 0;
-		delete[] _ppObjects;
-		_ppObjects = NULL;
+		++i;
+		assert(i < _objCount);
 	}
-	else
+	for( ; i + 1 < _objCount; ++i )
 	{
-		GC_RigidBodyStatic **tmp = new GC_RigidBodyStatic* [_objCount - 1];
-		int j = 0;
-		for( int i = 0; i < _objCount; ++i )
-		{
-			if( object == _ppObjects[i] ) continue;
-			tmp[j++] = _ppObjects[i];
-		}
-		_objCount--;
-		assert(j == _objCount);
-		delete[] _ppObjects;
-		_ppObjects = tmp;
+		Slot(i) = Slot(i + 1);
 	}
+	--_objCount;
 
-	UpdateProperties();
+	// release the last chunk if it became empty
+	if( _objCount >= INLINE_COUNT && 0 == (_objCount - INLINE_COUNT) % CHUNK_SIZE )
+	{
+		Chunk **tail = &_chunks;
+		while( (*tail)->next )
+			tail = &(*tail)->next;
+		_chunkPool.Free(*tail);
+		*tail = NULL;
+	}
 }
 
 ////////////////////////////////////////////////////////////
 
 Field::Field()
+  : _cells(NULL)
+  , _session(0)
+  , _batch(0)
+  , _cx(0)
+  , _cy(0)
 {
-	_cells = NULL;
-	_cx    = 0;
-	_cy    = 0;
-
-	_edgeCell._prop = 0xFF;
-	_edgeCell._x    = -1;
-	_edgeCell._y    = -1;
 }
 
 Field::~Field()
@@ -134,17 +175,21 @@ Field::~Field()
 
 void Field::Clear()
 {
-	if( _cells )
-	{
-		for( int i = 0; i < _cy; i++ )
-			delete[] _cells[i];
-		delete[] _cells;
-		//-----------
-		_cells = NULL;
-		_cx    = 0;
-		_cy    = 0;
-	}
-	assert(0 == _cx && 0 == _cy);
+	delete[] _cells;
+	_cells = NULL;
+	_pass.clear();
+	_nodes.clear();
+	_dirtyCells.clear();
+	_cx = 0;
+	_cy = 0;
+}
+
+void Field::SetPassability(int x, int y, unsigned char value)
+{
+	unsigned int i = y * _cx + x;
+	unsigned int shift = (i & 3) << 1;
+	unsigned char code = 0xFF == value ? 2 : (value ? 1 : 0);
+	_pass[i >> 2] = (_pass[i >> 2] & ~(3 << shift)) | (code << shift);
 }
 
 void Field::Resize(int cx, int cy)
@@ -153,19 +198,26 @@ void Field::Resize(int cx, int cy)
 	Clear();
 	_cx = cx;
 	_cy = cy;
-	_cells = new FieldCell* [_cy];
+	_cells = new FieldCell[_cx * _cy];
+	_pass.resize((_cx * _cy + 3) / 4, 0);
+	_nodes.resize(_cx * _cy);
+	for( size_t i = 0; i < _nodes.size(); ++i )
+	{
+		_nodes[i].session = 0;
+	}
+	_session = 0;
+
+	// the border is never passable
+	for( int x = 0; x < _cx; x++ )
+	{
+		SetPassability(x, 0, 0xFF);
+		SetPassability(x, _cy - 1, 0xFF);
+	}
 	for( int y = 0; y < _cy; y++ )
 	{
-		_cells[y] = new FieldCell[_cx];
-		for( int x = 0; x < _cx; x++ )
-		{
-			(*this)(x, y)._x = x;
-			(*this)(x, y)._y = y;
-			if( 0 == x || 0 == y || _cx-1 == x || _cy-1 == y )
-				(*this)(x, y)._prop = 0xFF;
-		}
+		SetPassability(0, y, 0xFF);
+		SetPassability(_cx - 1, y, 0xFF);
 	}
-	FieldCell::_sessionId = 0;
 }
 
 void Field::ProcessObject(GC_RigidBodyStatic *object, bool add)
@@ -184,25 +236,64 @@ void Field::ProcessObject(GC_RigidBodyStatic *object, bool add)
 	for( int y = ymin; y <= ymax; y++ )
 	{
 		if( add )
-		{
-			(*this)(x, y).AddObject(object);
-		}
+			AddObject(x, y, object);
 		else
-		{
-			(*this)(x, y).RemoveObject(object);
-			if( 0 == x || 0 == y || _cx-1 == x || _cy-1 == y )
-				(*this)(x, y)._prop = 0xFF;
-		}
+			RemoveObject(x, y, object);
 	}
 }
 
-#ifdef _DEBUG
-FieldCell& Field::operator() (int x, int y)
+void Field::UpdatePassability(int x, int y)
 {
-	assert(NULL != _cells);
-	return (x >= 0 && x < _cx && y >= 0 && y < _cy) ? _cells[y][x] : _edgeCell;
+	if( x > 0 && y > 0 && x < _cx-1 && y < _cy-1 )
+	{
+		if( _batch )
+			_dirtyCells.push_back(y * _cx + x);
+		else
+			SetPassability(x, y, _cells[y * _cx + x].CalcPassability());
+	}
 }
 
+void Field::AddObject(int x, int y, GC_RigidBodyStatic *object)
+{
+	if( x >= 0 && x < _cx && y >= 0 && y < _cy )
+	{
+		_cells[y * _cx + x].AddObject(object);
+		UpdatePassability(x, y);
+	}
+}
+
+void Field::RemoveObject(int x, int y, GC_RigidBodyStatic *object)
+{
+	if( x >= 0 && x < _cx && y >= 0 && y < _cy )
+	{
+		_cells[y * _cx + x].RemoveObject(object);
+		UpdatePassability(x, y);
+	}
+}
+
+void Field::BeginBatch()
+{
+	++_batch;
+}
+
+void Field::EndBatch()
+{
+	assert(_batch > 0);
+	if( 0 == --_batch )
+	{
+		std::sort(_dirtyCells.begin(), _dirtyCells.end());
+		_dirtyCells.erase(std::unique(_dirtyCells.begin(), _dirtyCells.end()), _dirtyCells.end());
+		for( size_t i = 0; i < _dirtyCells.size(); ++i )
+		{
+			int x = _dirtyCells[i] % _cx;
+			int y = _dirtyCells[i] / _cx;
+			SetPassability(x, y, _cells[_dirtyCells[i]].CalcPassability());
+		}
+		_dirtyCells.clear();
+	}
+}
+
+#ifdef _DEBUG
 void Field::Dump()
 {
 	TRACE("==== Field dump ====");
@@ -212,7 +303,7 @@ void Field::Dump()
 		char buf[1024] = {0};
 		for( int x = 0; x < _cx; x++ )
 		{
-			switch( (*this)(x, y).Properties() )
+			switch( GetPassability(x, y) )
 			{
 			case 0:
 				strcat(buf, " ");
@@ -230,7 +321,6 @@ void Field::Dump()
 
 	TRACE("=== end of dump ====");
 }
-
 #endif
 
 ////////////////////////////////////////////////////////////
@@ -250,6 +340,8 @@ EditorModeListenerHelper::~EditorModeListenerHelper()
 // don't create game objects in the constructor
 Level::Level()
   : _modeEditor(false)
+  , _batch(0)
+  , _batchAreaEmpty(true)
   , _time(0)
   , _limitHit(false)
   , _frozen(false)
@@ -260,6 +352,10 @@ Level::Level()
   , _sy(0)
   , _seed(1)
   , _serviceListener(NULL)
+  , grid_lights_reach(0)
+  , contacts(new RigidBodyContacts())
+  , jobs_turret(TURET_JOB_BUDGET)
+  , jobs_ai(AI_JOB_BUDGET)
   , _texBack(g_texman->FindSprite("background"))
   , _texGrid(g_texman->FindSprite("grid"))
 #ifdef NETWORK_DEBUG
@@ -314,6 +410,9 @@ void Level::Resize(int X, int Y)
 	grid_wood.resize(_locationsX, _locationsY);
 	grid_water.resize(_locationsX, _locationsY);
 	grid_pickup.resize(_locationsX, _locationsY);
+	grid_vehicles.resize(_locationsX, _locationsY);
+	grid_lights.resize(_locationsX, _locationsY);
+	grid_lights_reach = 0;
 
 	_field.Resize(X + 1, Y + 1);
 }
@@ -327,6 +426,8 @@ void Level::Clear()
 	{
 		obj->Kill();
 	}
+	PropertyTable::Flush();
+	ts_fixed.SetTime(0); // alarms are computed from it, so each match starts at zero
 
 	// reset info
 	_infoAuthor.clear();
@@ -451,6 +552,7 @@ void Level::Unserialize(const char *fileName)
 		g_conf.sv_nightmode.Set(sh.nightmode);
 
 		_time = sh.time;
+		ts_fixed.SetTime(sh.stepTime);
 		Resize(sh.width, sh.height);
 
 
@@ -598,6 +700,7 @@ void Level::Serialize(const char *fileName)
 	sh.timelimit    = g_conf.sv_timelimit.GetFloat();
 	sh.nightmode    = g_conf.sv_nightmode.Get();
 	sh.time         = _time;
+	sh.stepTime     = ts_fixed.GetTime();
 	sh.width        = (int) _sx / CELL_SIZE;
 	sh.height       = (int) _sy / CELL_SIZE;
 
@@ -719,18 +822,31 @@ void Level::Import(const SafePtr<FS::Stream> &s)
 
 	Resize(width, height);
 
-	while( file.NextObject() )
-	{
-		float x = 0;
-		float y = 0;
-		file.getObjectAttribute("x", x);
-		file.getObjectAttribute("y", y);
-		ObjectType t = RTTypes::Inst().GetTypeByName(file.GetCurrentClassName());
-		if( INVALID_OBJECT_TYPE == t )
-			continue;
-		GC_Object *object = RTTypes::Inst().GetTypeInfo(t).Create(x, y);
-		object->MapExchange(file);
+	std::vector<ObjectType> types; // resolved once per class defined in the file
+	BeginBatch();
+	try
+	{
+		while( file.NextObject() )
+		{
+			while( types.size() <= file.GetCurrentClassIndex() )
+				types.push_back(RTTypes::Inst().GetTypeByName(file.GetClassName(types.size())));
+			ObjectType t = types[file.GetCurrentClassIndex()];
+			if( INVALID_OBJECT_TYPE == t )
+				continue;
+			float x = 0;
+			float y = 0;
+			file.getObjectAttribute("x", x);
+			file.getObjectAttribute("y", y);
+			GC_Object *object = RTTypes::Inst().GetTypeInfo(t).Create(x, y);
+			object->MapExchange(file);
+		}
 	}
+	catch( ... )
+	{
+		EndBatch();
+		throw;
+	}
+	EndBatch();
 	GC_Camera::UpdateLayout();
 }
 
@@ -798,6 +914,13 @@ void Level::SetEditorMode(bool editorModeEnable)
 	}
 }
 
+static bool IsEdObject(GC_Object *object, int layer)
+{
+	RTTypes &types = RTTypes::Inst();
+	return types.IsRegistered(object->GetType())
+		&& (-1 == layer || types.GetTypeInfo(object->GetType()).layer == layer);
+}
+
 GC_2dSprite* Level::PickEdObject(const vec2d &pt, int layer)
 {
 	for( int i = Z_COUNT; i--; )
@@ -816,16 +939,9 @@ GC_2dSprite* Level::PickEdObject(const vec2d &pt, int layer)
 				FRECT frect;
 				object->GetGlobalRect(frect);
 
-				if( PtInFRect(frect, pt) )
+				if( PtInFRect(frect, pt) && IsEdObject(object, layer) )
 				{
-					for( int i = 0; i < RTTypes::Inst().GetTypeCount(); ++i )
-					{
-						if( object->GetType() == RTTypes::Inst().GetTypeByIndex(i)
-						    && (-1 == layer || RTTypes::Inst().GetTypeInfoByIndex(i).layer == layer) )
-						{
-							return object;
-						}
-					}
+					return object;
 				}
 			}
 		}
@@ -834,6 +950,140 @@ GC_2dSprite* Level::PickEdObject(const vec2d &pt, int layer)
 	return NULL;
 }
 
+void Level::PickEdObjects(std::vector<GC_2dSprite*> &result, const FRECT &rect, int layer)
+{
+	FRECT locations = { rect.left / LOCATION_SIZE, rect.top / LOCATION_SIZE,
+	                    rect.right / LOCATION_SIZE, rect.bottom / LOCATION_SIZE };
+
+	for( int i = Z_COUNT; i--; )
+	{
+		PtrList<ObjectList> receive;
+		z_grids[i].OverlapRect(receive, locations);
+
+		PtrList<ObjectList>::iterator rit = receive.begin();
+		for( ; rit != receive.end(); rit++ )
+		{
+			ObjectList::iterator it = (*rit)->begin();
+			for( ; it != (*rit)->end(); ++it )
+			{
+				GC_2dSprite *object = static_cast<GC_2dSprite*>(*it);
+				if( PtInFRect(rect, object->GetPos()) && IsEdObject(object, layer) )
+				{
+					result.push_back(object);
+				}
+			}
+		}
+	}
+}
+
+void Level::PickEdObjects(std::vector<GC_2dSprite*> &result, const vec2d *lasso, size_t count, int layer)
+{
+	if( count < 3 )
+	{
+		return;
+	}
+
+	FRECT bounds = { lasso[0].x, lasso[0].y, lasso[0].x, lasso[0].y };
+	for( size_t i = 1; i < count; ++i )
+	{
+		bounds.left   = std::min(bounds.left, lasso[i].x);
+		bounds.top    = std::min(bounds.top, lasso[i].y);
+		bounds.right  = std::max(bounds.right, lasso[i].x);
+		bounds.bottom = std::max(bounds.bottom, lasso[i].y);
+	}
+
+	std::vector<GC_2dSprite*> candidates;
+	PickEdObjects(candidates, bounds, layer);
+
+	for( size_t i = 0; i < candidates.size(); ++i )
+	{
+		// even-odd rule
+		vec2d pt = candidates[i]->GetPos();
+		bool inside = false;
+		for( size_t a = 0, b = count - 1; a < count; b = a++ )
+		{
+			if( (lasso[a].y > pt.y) != (lasso[b].y > pt.y) &&
+			    pt.x < lasso[a].x + (lasso[b].x - lasso[a].x) * (pt.y - lasso[a].y) / (lasso[b].y - lasso[a].y) )
+			{
+				inside = !inside;
+			}
+		}
+		if( inside )
+		{
+			result.push_back(candidates[i]);
+		}
+	}
+}
+
+void Level::BeginBatch()
+{
+	++_batch;
+	_field.BeginBatch();
+}
+
+void Level::EndBatch()
+{
+	assert(_batch > 0);
+	_field.EndBatch();
+	if( 0 == --_batch && !_batchAreaEmpty )
+	{
+		_batchAreaEmpty = true;
+		GC_Wood::UpdateTiles(_batchArea);
+		GC_Water::UpdateTiles(_batchArea);
+	}
+}
+
+void Level::AddBatchArea(const FRECT &rect)
+{
+	assert(_batch > 0);
+	if( _batchAreaEmpty )
+	{
+		_batchArea = rect;
+		_batchAreaEmpty = false;
+	}
+	else
+	{
+		_batchArea.left   = std::min(_batchArea.left, rect.left);
+		_batchArea.top    = std::min(_batchArea.top, rect.top);
+		_batchArea.right  = std::max(_batchArea.right, rect.right);
+		_batchArea.bottom = std::max(_batchArea.bottom, rect.bottom);
+	}
+}
+
+DWORD Level::GetStateHash()
+{
+	struct Hash
+	{
+		DWORD value;
+		void Add(DWORD x)
+		{
+			value = value ^ x ^ 0xD202EF8D;
+			value = (value >> 1) | ((value & 0x00000001) << 31);
+		}
+		void Add(float x)
+		{
+			Add(reinterpret_cast<const DWORD&>(x));
+		}
+	};
+
+	Hash hash = { 0 };
+	hash.Add((DWORD) _seed);
+	hash.Add(_time);
+	FOREACH( GetList(LIST_objects), GC_Object, object )
+	{
+		if( GC_Actor *actor = dynamic_cast<GC_Actor *>(object) )
+		{
+			hash.Add(actor->GetPos().x);
+			hash.Add(actor->GetPos().y);
+		}
+		if( GC_RigidBodyStatic *body = dynamic_cast<GC_RigidBodyStatic *>(object) )
+		{
+			hash.Add(body->GetHealth());
+		}
+	}
+	return hash.value;
+}
+
 int Level::net_rand()
 {
 	return ((_seed = _seed * 214013L + 2531011L) >> 16) & RAND_MAX;
@@ -968,6 +1218,48 @@ void Level::TraceAll( Grid<ObjectList> &list,
 	RayTrace(list, selector);
 }
 
+void Level::QueryVehicles(const vec2d &center, float radius, std::vector<GC_Vehicle*> &result)
+{
+	struct VehicleDist
+	{
+		GC_Vehicle *veh;
+		float dist;
+		bool operator < (const VehicleDist &other) const { return dist < other.dist; }
+	};
+
+	PtrList<ObjectList> receive;
+	FRECT rt = {
+		(center.x - radius) / LOCATION_SIZE,
+		(center.y - radius) / LOCATION_SIZE,
+		(center.x + radius) / LOCATION_SIZE,
+		(center.y + radius) / LOCATION_SIZE};
+	grid_vehicles.OverlapRect(receive, rt);
+
+	std::vector<VehicleDist> found;
+	for( PtrList<ObjectList>::iterator i = receive.begin(); i != receive.end(); ++i )
+	{
+		for( ObjectList::iterator it = (*i)->begin(); it != (*i)->end(); ++it )
+		{
+			VehicleDist vd;
+			vd.veh = static_cast<GC_Vehicle *>(*it);
+			vd.dist = (vd.veh->GetPos() - center).sqr();
+			if( vd.dist < radius * radius )
+			{
+				found.push_back(vd);
+			}
+		}
+	}
+
+	// stable order keeps the result identical on all network peers
+	std::stable_sort(found.begin(), found.end());
+
+	result.clear();
+	for( size_t i = 0; i < found.size(); ++i )
+	{
+		result.push_back(found[i].veh);
+	}
+}
+
 void Level::DrawBackground(size_t tex) const
 {
 	const LogicalTexture &lt = g_texman->Get(tex);
@@ -996,6 +1288,7 @@ void Level::DrawBackground(size_t tex) const
 
 void Level::Step(const ControlPacketVector &ctrl, float dt)
 {
+	PROFILE_SCOPE(tagStep);
 	_time += dt;
 
 	if( !_frozen )
@@ -1016,13 +1309,11 @@ void Level::Step(const ControlPacketVector &ctrl, float dt)
 
 
 		_safeMode = false;
-		for( ObjectList::safe_iterator it = ts_fixed.safe_begin(); it != ts_fixed.end(); ++it )
+		ts_fixed.Step(dt);
 		{
-			(*it)->TimeStepFixed(dt);
-			if( *it )
-				(*it)->TimeStepFloat(dt);
+			PROFILE_SCOPE(tagResponse);
+			GC_RigidBodyDynamic::ProcessResponse(dt);
 		}
-		GC_RigidBodyDynamic::ProcessResponse(dt);
 		_safeMode = true;
 	}
 
@@ -1055,7 +1346,9 @@ void Level::Step(const ControlPacketVector &ctrl, float dt)
 	fprintf(_dump, "\n### frame %04d ###\n", _frame);
 
 	DWORD dwCheckSum = 0;
-	for( ObjectList::safe_iterator it = ts_fixed.safe_begin(); it != ts_fixed.end(); ++it )
+	std::vector<GC_Object*> objects;
+	ts_fixed.GetObjects(objects);
+	for( std::vector<GC_Object*>::const_iterator it = objects.begin(); it != objects.end(); ++it )
 	{
 		if( DWORD cs = (*it)->checksum() )
 		{
@@ -1071,6 +1364,7 @@ void Level::Step(const ControlPacketVector &ctrl, float dt)
 
 void Level::RunCmdQueue(float dt)
 {
+	PROFILE_SCOPE(tagCmdQueue);
 	assert(_safeMode);
 
 	lua_State * const L = g_env.L;
@@ -1138,7 +1432,7 @@ void Level::Render() const
 		world.right = world.left + (float) g_render->GetWidth() / _defaultCamera.GetZoom();
 		world.bottom = world.top + (float) g_render->GetHeight() / _defaultCamera.GetZoom();
 
-		RenderInternal(world);
+		RenderInternal(&world, 1);
 	}
 	else
 	{
@@ -1169,15 +1463,30 @@ void Level::Render() const
 				singleCamera->GetZoom(),
 				g_conf.g_rotcamera.Get() ? singleCamera->GetAngle() : 0);
 
-			RenderInternal(world);
+			RenderInternal(&world, 1);
 		}
 		else
 		{
+			// the views share a single pass over the level. primitives are
+			// recorded in world space and replayed through each camera
+			std::vector<FRECT> views;
+			FOREACH( GetList(LIST_cameras), GC_Camera, pCamera )
+			{
+				views.push_back(FRECT());
+				pCamera->GetWorld(views.back());
+			}
+
+			IRender *render = g_render;
+			_recorder.Begin(render);
+			g_render = &_recorder;
+			RenderInternal(&views[0], views.size());
+			g_render = render;
+
 			// render from each camera
+			size_t i = 0;
 			FOREACH( GetList(LIST_cameras), GC_Camera, pCamera )
 			{
-				FRECT world;
-				pCamera->GetWorld(world);
+				const FRECT &world = views[i++];
 
 				RECT screen;
 				pCamera->GetScreen(screen);
@@ -1188,7 +1497,10 @@ void Level::Render() const
 					pCamera->GetZoom(),
 					g_conf.g_rotcamera.Get() ? pCamera->GetAngle() : 0);
 
-				RenderInternal(world);
+				// keep the margin of the location grid the view used to be drawn with
+				FRECT bounds = { world.left - LOCATION_SIZE, world.top - LOCATION_SIZE,
+				                 world.right + LOCATION_SIZE, world.bottom + LOCATION_SIZE };
+				_recorder.Replay(&bounds);
 			}
 		}
 	}
@@ -1201,8 +1513,11 @@ void Level::Render() const
 	}
 }
 
-void Level::RenderInternal(const FRECT &world) const
+void Level::RenderInternal(const FRECT *views, size_t count) const
 {
+	PROFILE_SCOPE(tagRender);
+	assert(count > 0);
+
 	//
 	// draw lights to alpha channel
 	//
@@ -1210,20 +1525,40 @@ void Level::RenderInternal(const FRECT &world) const
 	g_render->SetMode(RM_LIGHT);
 	if( g_conf.sv_nightmode.Get() )
 	{
-		float xmin = std::max(0.0f, world.left);
-		float ymin = std::max(0.0f, world.top);
-		float xmax = std::min(_sx, world.right);
-		float ymax = std::min(_sy, world.bottom);
+		FRECT bounds = views[0];
+		for( size_t i = 1; i < count; ++i )
+		{
+			bounds.left = std::min(bounds.left, views[i].left);
+			bounds.top = std::min(bounds.top, views[i].top);
+			bounds.right = std::max(bounds.right, views[i].right);
+			bounds.bottom = std::max(bounds.bottom, views[i].bottom);
+		}
+
+		// lights are registered by their centers, so look around as far as they can shine
+		int lxmin = __max(0, int((bounds.left - grid_lights_reach) / LOCATION_SIZE));
+		int lymin = __max(0, int((bounds.top - grid_lights_reach) / LOCATION_SIZE));
+		int lxmax = __min(_locationsX - 1, int((bounds.right + grid_lights_reach) / LOCATION_SIZE));
+		int lymax = __min(_locationsY - 1, int((bounds.bottom + grid_lights_reach) / LOCATION_SIZE));
 
-		FOREACH( GetList(LIST_lights), GC_Light, pLight )
+		for( int x = lxmin; x <= lxmax; ++x )
+		for( int y = lymin; y <= lymax; ++y )
 		{
-			if( pLight->IsActive() &&
-				pLight->GetPos().x + pLight->GetRenderRadius() > xmin &&
-				pLight->GetPos().x - pLight->GetRenderRadius() < xmax &&
-				pLight->GetPos().y + pLight->GetRenderRadius() > ymin &&
-				pLight->GetPos().y - pLight->GetRenderRadius() < ymax )
+			FOREACH( grid_lights.element(x,y), GC_Light, pLight )
 			{
-				pLight->Shine();
+				if( pLight->IsActive() )
+				{
+					for( size_t i = 0; i < count; ++i )
+					{
+						if( pLight->GetPos().x + pLight->GetRenderRadius() > std::max(0.0f, views[i].left) &&
+							pLight->GetPos().x - pLight->GetRenderRadius() < std::min(_sx, views[i].right) &&
+							pLight->GetPos().y + pLight->GetRenderRadius() > std::max(0.0f, views[i].top) &&
+							pLight->GetPos().y - pLight->GetRenderRadius() < std::min(_sy, views[i].bottom) )
+						{
+							pLight->Shine();
+							break;
+						}
+					}
+				}
 			}
 		}
 	}
@@ -1241,19 +1576,44 @@ void Level::RenderInternal(const FRECT &world) const
 		DrawBackground(_texGrid);
 
 
-	int xmin = __max(0, int(world.left / LOCATION_SIZE));
-	int ymin = __max(0, int(world.top / LOCATION_SIZE));
-	int xmax = __min(_locationsX - 1, int(world.right / LOCATION_SIZE));
-	int ymax = __min(_locationsY - 1, int(world.bottom / LOCATION_SIZE) + 1);
+	// each location seen from any of the views is drawn once
+	_visibleCells.assign(_locationsX * _locationsY, 0);
+
+	int xmin = _locationsX;
+	int ymin = _locationsY;
+	int xmax = -1;
+	int ymax = -1;
+
+	for( size_t i = 0; i < count; ++i )
+	{
+		int vxmin = __max(0, int(views[i].left / LOCATION_SIZE));
+		int vymin = __max(0, int(views[i].top / LOCATION_SIZE));
+		int vxmax = __min(_locationsX - 1, int(views[i].right / LOCATION_SIZE));
+		int vymax = __min(_locationsY - 1, int(views[i].bottom / LOCATION_SIZE) + 1);
+
+		for( int x = vxmin; x <= vxmax; ++x )
+		for( int y = vymin; y <= vymax; ++y )
+		{
+			_visibleCells[_locationsX * y + x] = 1;
+		}
+
+		xmin = __min(xmin, vxmin);
+		ymin = __min(ymin, vymin);
+		xmax = __max(xmax, vxmax);
+		ymax = __max(ymax, vymax);
+	}
 
 	for( int z = 0; z < Z_COUNT; ++z )
 	{
 		for( int x = xmin; x <= xmax; ++x )
 		for( int y = ymin; y <= ymax; ++y )
 		{
-			FOREACH(z_grids[z].element(x,y), GC_2dSprite, object)
+			if( _visibleCells[_locationsX * y + x] )
 			{
-				object->Draw();
+				FOREACH(z_grids[z].element(x,y), GC_2dSprite, object)
+				{
+					object->Draw();
+				}
 			}
 		}
 
@@ -9,9 +9,14 @@
 #include "network/ControlPacket.h"
 
 #include "video/RenderBase.h"
+#include "video/RenderRecorder.h"
 
 #include "DefaultCamera.h"
 
+#include "core/JobManager.h"
+
+#include "gc/TimeStepManager.h"
+
 
 #pragma region path finding stuff
 
@@ -21,110 +26,123 @@ namespace FS
 }
 class ClientBase;
 class GC_RigidBodyStatic;
+class GC_Vehicle;
+class GC_Turret;
+class GC_PlayerAI;
+class RigidBodyContacts;
 
-class Field;
+// objects covering a cell of the path finding grid. touched only when the
+// map changes and when a found path is converted to the attack list.
 class FieldCell
 {
-public:
-	static unsigned long _sessionId;    //   
-	//-----------------------------
-	short _x, _y;                       //  
-	//-----------------------------
-	unsigned long _mySession;        // ,      
-	//-----------------------------
-	GC_RigidBodyStatic **_ppObjects;
-	unsigned char _objCount;
-	unsigned char _prop;             // 0 - free, 1 - could be broken, 0xFF - impassable
-	//-----------------------------
-	void UpdateProperties();
-	FieldCell()
+	enum { INLINE_COUNT = 2, CHUNK_SIZE = 6 };
+	struct Chunk
 	{
-		_ppObjects   = NULL;
-		_objCount    = 0;
-		_prop        = 0;     // free
-		_mySession   = 0xffffffff;
-	}
-public:
+		GC_RigidBodyStatic *objects[CHUNK_SIZE];
+		Chunk *next;
+	};
+	static MemoryPool<Chunk> _chunkPool;
 
-	const FieldCell *_prevCell;
+	GC_RigidBodyStatic *_inline[INLINE_COUNT];
+	Chunk *_chunks;          // storage for objects beyond INLINE_COUNT
+	unsigned char _objCount;
 
-	inline int GetObjectsCount() const { return _objCount; }
-	inline GC_RigidBodyStatic* GetObject(int index) const { return _ppObjects[index]; }
+	GC_RigidBodyStatic*& Slot(int index);
 
-	inline bool IsChecked() const { return _mySession == _sessionId; }
-	inline void Check()           { _mySession = _sessionId;         }
+	FieldCell(const FieldCell &other); // no copy
+	FieldCell& operator = (const FieldCell &other);
 
-	inline void UpdatePath(float before, short x, short y)
-	{
-		int dx = abs(x - GetX());
-		int dy = abs(y - GetY());
-		float pathAfter = (float) __max(dx, dy) + (float) __min(dx, dy) * 0.4142f;
-		_before = before;
-		_total = before + pathAfter;
-	}
+public:
+	FieldCell();
+	~FieldCell();
+
+	inline int GetObjectsCount() const { return _objCount; }
+	GC_RigidBodyStatic* GetObject(int index) const;
 
 	void AddObject(GC_RigidBodyStatic *object);
 	void RemoveObject(GC_RigidBodyStatic *object);
 
-	inline short GetX()               const { return _x;    }
-	inline short GetY()               const { return _y;    }
-	inline unsigned char Properties() const { return _prop; }
-
-	inline float Total() const { return _total; }
-	inline float Before() const { return _before; }
-
-private:
-	float _before;          // path cost to this node
-	float _total;           // total path cost estimate
-
-	FieldCell(const FieldCell &other); // no copy
-	FieldCell& operator = (const FieldCell &other);
+	unsigned char CalcPassability() const; // 0 - free, 1 - could be broken, 0xFF - impassable
 };
 
-class RefFieldCell
+// per-search scratch data of the path finder
+struct FieldNode
 {
-	FieldCell *_cell;
-public:
-	RefFieldCell(FieldCell &cell) { _cell = &cell; }
-	operator FieldCell& () const { return *_cell; }
-	bool operator > (const RefFieldCell &cell) const
-	{
-		return _cell->Total() > cell._cell->Total();
-	}
+	unsigned long session;   // the node is valid only if it matches the field session
+	int   prev;              // index of the previous node or -1
+	float before;            // path cost to this node
+	float total;             // total path cost estimate
 };
 
-
 class Field
 {
 	FieldCell _edgeCell;
-	FieldCell **_cells;
+	FieldCell *_cells;               // cold: object lists
+	std::vector<unsigned char> _pass; // hot: 2 bits of passability per cell
+	std::vector<FieldNode> _nodes;    // path finder scratch
+	std::vector<int> _dirtyCells;     // passability to recalculate at the end of a batch
+	unsigned long _session;
+	int _batch;
 	int _cx;
 	int _cy;
 
 	void Clear();
+	void SetPassability(int x, int y, unsigned char value);
+	void UpdatePassability(int x, int y);
 
 public:
-	static void NewSession() { ++FieldCell::_sessionId; }
-
 	Field();
 	~Field();
 
 	void Resize(int cx, int cy);
 	void ProcessObject(GC_RigidBodyStatic *object, bool add);
+	void AddObject(int x, int y, GC_RigidBodyStatic *object);    // cells out of the field are ignored
+	void RemoveObject(int x, int y, GC_RigidBodyStatic *object);
+
+	// objects added or removed within a batch update passability once in EndBatch
+	void BeginBatch();
+	void EndBatch();
+
 	int GetX() const { return _cx; }
 	int GetY() const { return _cy; }
 
+	// 0 - free, 1 - could be broken, 0xFF - impassable or out of the field
+	inline unsigned char GetPassability(int x, int y) const
+	{
+		static const unsigned char values[4] = { 0, 1, 0xFF, 0xFF };
+		if( x < 0 || x >= _cx || y < 0 || y >= _cy )
+			return 0xFF;
+		unsigned int i = y * _cx + x;
+		return values[(_pass[i >> 2] >> ((i & 3) << 1)) & 3];
+	}
 
-#ifdef _DEBUG
-	FieldCell& operator() (int x, int y);
-	void Dump();
-#else
-	inline FieldCell& operator() (int x, int y)
+	const FieldCell& GetCell(int x, int y) const
 	{
-		return (x >= 0 && x < _cx && y >= 0 && y < _cy) ? _cells[y][x] : _edgeCell;
+		return (x >= 0 && x < _cx && y >= 0 && y < _cy) ? _cells[y * _cx + x] : _edgeCell;
 	}
-#endif
 
+
+	//
+	// path finder support
+	//
+
+	void NewSession() { ++_session; }
+
+	inline int GetNodeIndex(int x, int y) const
+	{
+		assert(x >= 0 && x < _cx && y >= 0 && y < _cy);
+		return y * _cx + x;
+	}
+	inline int GetNodeX(int index) const { return index % _cx; }
+	inline int GetNodeY(int index) const { return index / _cx; }
+	inline FieldNode& GetNode(int index) { return _nodes[index]; }
+
+	inline bool IsChecked(int index) const { return _nodes[index].session == _session; }
+	inline void Check(int index) { _nodes[index].session = _session; }
+
+#ifdef _DEBUG
+	void Dump();
+#endif
 };
 
 #pragma endregion
@@ -157,6 +175,8 @@ class Level
 {
 	friend class GC_Object;
 
+	AllocationContext _allocContext; // declared first to outlive all other members
+
 	std::map<const GC_Object*, string_t>  _objectToStringMaps[32];
 	std::map<string_t, const GC_Object*>  _nameToObjectMap; // TODO: try to avoid name string duplication
 
@@ -168,6 +188,7 @@ class Level
 		float timelimit;
 		int   fraglimit;
 		float time;
+		float stepTime;  // clock of ts_fixed that times the sleeping objects
 		int   width;
 		int   height;
 		char  theme[MAX_PATH];
@@ -177,6 +198,10 @@ class Level
 	std::set<IEditorModeListener*> _editorModeListeners;
 	bool    _modeEditor;
 
+	int     _batch;
+	FRECT   _batchArea;        // wood and water added or removed within the batch
+	bool    _batchAreaEmpty;
+
 public:
 
 #ifndef NDEBUG
@@ -197,8 +222,20 @@ public:
 	Grid<ObjectList>  grid_wood;
 	Grid<ObjectList>  grid_water;
 	Grid<ObjectList>  grid_pickup;
+	Grid<ObjectList>  grid_vehicles;
+	Grid<ObjectList>  grid_lights;
+	float             grid_lights_reach; // no light in grid_lights shines farther from its center
+
+	TimeStepManager ts_fixed;
 
-	ObjectList     ts_fixed;
+	// simulation state that is shared by objects of the same class. owning it
+	// here is only a first step towards several matches per process: objects
+	// still reach it through g_level, the memory pools are process-wide and
+	// not thread-safe, and g_env.L is shared, so only one level can be
+	// simulated at a time
+	std::unique_ptr<RigidBodyContacts> contacts;
+	JobManager<GC_Turret>    jobs_turret;
+	JobManager<GC_PlayerAI>  jobs_ai;
 
 	// graphics
 	ObjectList        z_globals[Z_COUNT];
@@ -209,6 +246,8 @@ public:
 
 	size_t _texBack;
 	size_t _texGrid;
+	mutable std::vector<char> _visibleCells; // locations seen from any view in the current frame
+	mutable RenderRecorder    _recorder;     // replays the frame into each view of a split screen
 	void DrawBackground(size_t tex) const;
 
 /////////////////////////////////////
@@ -277,6 +316,9 @@ public:
 	bool IsGamePaused() const;
 	GC_Object* FindObject(const string_t &name) const;
 
+	// positions, health and the random seed; equal on all peers that are in sync
+	DWORD GetStateHash();
+
 	int   net_rand();
 	float net_frand(float max);
 	vec2d net_vrand(float len);
@@ -288,7 +330,7 @@ public:
                        vec2d &out_fake );  // out: fake target position
 
 
-	void RenderInternal(const FRECT &world) const;
+	void RenderInternal(const FRECT *views, size_t count) const;
 
 
 	//
@@ -319,6 +361,10 @@ public:
 	template<class SelectorType>
 	void RayTrace(Grid<ObjectList> &list, SelectorType &s) const;
 
+	// vehicles with centers within the radius, nearest first. callers looking
+	// for the nearest visible target may stop tracing at the first hit.
+	void QueryVehicles(const vec2d &center, float radius, std::vector<GC_Vehicle*> &result);
+
 
 	//
 	// editor
@@ -328,6 +374,17 @@ public:
 	void SetEditorMode(bool editorModeEnable);
 	GC_2dSprite* PickEdObject(const vec2d &pt, int layer);
 
+	// editor objects with positions inside the rectangle or the lasso polygon
+	void PickEdObjects(std::vector<GC_2dSprite*> &result, const FRECT &rect, int layer);
+	void PickEdObjects(std::vector<GC_2dSprite*> &result, const vec2d *lasso, size_t count, int layer);
+
+	// groups creation and removal of many objects. the field passability and
+	// the borders of wood and water are updated once when the batch ends
+	void BeginBatch();
+	void EndBatch();
+	bool IsBatch() const { return _batch > 0; }
+	void AddBatchArea(const FRECT &rect);
+
 
 	//
 	// config callback handlers
@@ -34,6 +34,8 @@
 #include "gc/Player.h"
 
 #include "fs/FileSystem.h"
+#include "fs/PackFileSystem.h"
+#include "fs/OverlayFileSystem.h"
 
 #include "res/resource.h"
 
@@ -297,6 +299,36 @@ bool ZodApp::Pre()
 	TRACE("Mounting file system...");
 	g_fs = FS::OSFileSystem::Create("data");
 
+	// every data/<name>.pak goes under the directory data/<name>: loose files
+	// there override the archive, and everything written there goes to disk
+	std::set<string_t> packs;
+	g_fs->EnumAllFiles(packs, TEXT("*.pak"));
+	for( std::set<string_t>::const_iterator it = packs.begin(); it != packs.end(); ++it )
+	{
+		try
+		{
+			string_t nodeName = it->substr(0, it->rfind(TEXT('.')));
+			SafePtr<FS::FileSystem> pack = FS::PackFileSystem::Create(g_fs->Open(*it), nodeName);
+			SafePtr<FS::FileSystem> dir = g_fs->GetFileSystem(nodeName, true, true);
+			if( dir )
+			{
+				dir->Unmount(); // the overlay takes its place
+			}
+			else
+			{
+				TRACE("'%s' is read-only: could not create directory", it->c_str());
+			}
+			if( !FS::OverlayFileSystem::Create(dir, pack, nodeName)->MountTo(g_fs) )
+			{
+				TRACE("'%s' is not mounted: node already exists", it->c_str());
+			}
+		}
+		catch( const std::exception &e )
+		{
+			TRACE("could not mount '%s': %s", it->c_str(), e.what());
+		}
+	}
+
 
 	//
 	// init config system
@@ -501,6 +533,8 @@ bool ZodApp::Pre()
 
 void ZodApp::Idle()
 {
+	ProfileTag::FlushFrame(); // the time spent since the previous call
+
 	_inputMgr->InquireInputDevices();
 
 	// estimate current frame time
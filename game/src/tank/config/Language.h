@@ -267,6 +267,8 @@ REFLECTION_BEGIN(LangCache)
 		"Mouse wheel scroll   - choose object type to create\n"
 		"Left mouse button    - object create/select/modify\n"
 		"Right mouse button   - delete object\n"
+		"Shift + left drag    - fill area with objects\n"
+		"Shift + right drag   - delete objects inside lasso\n"
 		"\nPress and hold Ctrl to create object with default properties" )
 
 
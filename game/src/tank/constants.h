@@ -145,10 +145,16 @@ enum enumZOrder
 #define AI_MAX_SIGHT   20.0f
 #define AI_MAX_LEVEL   4U
 
+// SelectState may build several paths, so a bot costs more than a turret.
+// two bots think every frame; a bot in combat thinks more often.
+#define AI_JOB_COST    4
+#define AI_JOB_BUDGET  (AI_JOB_COST * 2)
+
 //-----------------------------------------------------------------------------
 #define TURET_ROCKET_RELOAD  0.9f
 #define TURET_CANON_RELOAD   0.4f
 #define TURET_SIGHT_RADIUS   500
+#define TURET_JOB_BUDGET     4    // looking for targets is a single trace per vehicle in sight
 
 //-----------------------------------------------------------------------------
 #define PLAYER_RESPAWN_DELAY 2.0f
@@ -0,0 +1,85 @@
+// DetMath.cpp
+
+#include "stdafx.h"
+#include "DetMath.h"
+
+#ifdef _MSC_VER
+#pragma float_control(precise, on)
+#pragma fp_contract(off)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// polynomial approximations from the Cephes library; the error is within
+// two units in the last place
+
+// ln(2) split into an exact high part and a correction
+static const float LN2_HI = 0.693359375f;
+static const float LN2_LO = -2.12194440e-4f;
+
+float DetExp(float x)
+{
+	if( x > 88.0f )
+		return std::numeric_limits<float>::infinity();
+	if( x < -87.0f )
+		return 0;
+
+	// x = n * ln(2) + r, |r| <= ln(2)/2
+	float n = floorf(x * 1.44269504088896341f + 0.5f);
+	float r = x - n * LN2_HI;
+	r = r - n * LN2_LO;
+
+	float z = r * r;
+	float p = 1.9875691500e-4f;
+	p = p * r + 1.3981999507e-3f;
+	p = p * r + 8.3334519073e-3f;
+	p = p * r + 4.1665795894e-2f;
+	p = p * r + 1.6666665459e-1f;
+	p = p * r + 5.0000001201e-1f;
+	p = p * z + r;
+	p = p + 1.0f;
+
+	return ldexpf(p, (int) n); // scaling by a power of two is exact
+}
+
+float DetLog(float x)
+{
+	assert(x > 0);
+
+	// x = m * 2^e, sqrt(1/2) <= m < sqrt(2)
+	int e;
+	float m = frexpf(x, &e);
+	if( m < 0.707106781186547524f )
+	{
+		--e;
+		m = m + m - 1.0f;
+	}
+	else
+	{
+		m = m - 1.0f;
+	}
+
+	float z = m * m;
+	float p = 7.0376836292e-2f;
+	p = p * m - 1.1514610310e-1f;
+	p = p * m + 1.1676998740e-1f;
+	p = p * m - 1.2420140846e-1f;
+	p = p * m + 1.4249322787e-1f;
+	p = p * m - 1.6668057665e-1f;
+	p = p * m + 2.0000714765e-1f;
+	p = p * m - 2.4999993993e-1f;
+	p = p * m + 3.3333331174e-1f;
+	p = p * m * z;
+
+	float fe = (float) e;
+	p = p + fe * LN2_LO;
+	p = p - 0.5f * z;
+	return (m + p) + fe * LN2_HI;
+}
+
+float DetSqrt(float x)
+{
+	return sqrtf(x);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
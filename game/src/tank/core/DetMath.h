@@ -0,0 +1,22 @@
+// DetMath.h
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// transcendental functions for the simulation. the results must be the same
+// bit for bit on every network peer, so instead of the CRT versions, which
+// differ between compilers and CPUs, they use fixed polynomials built from
+// basic IEEE operations only. DetMath.cpp is compiled with the precise
+// floating point model regardless of the project setting.
+
+float DetExp(float x);
+float DetLog(float x);  // x must be positive
+float DetSqrt(float x); // correctly rounded by IEEE, kept here to avoid /fp:fast shortcuts
+
+inline float Square(float x)
+{
+	return x * x;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
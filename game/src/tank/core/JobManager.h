@@ -1,45 +1,185 @@
 // JobManager.h
 
+#pragma once
+
+// distributes thinking time between members of the same class.
+// every frame the members are granted the right to work in round-robin
+// order until the frame budget is spent; boosted members are served first
+// but may take no more than a half of the budget. the result depends only
+// on the order of registration and on the frame time, so it is the same
+// on all network peers.
+//
+// members keep the ticket returned by RegisterMember; all operations are O(1)
+// except the grant pass that runs once per frame.
 
 template <class T>
 class JobManager
 {
-	std::list<const T*> _members;
-	typename std::list<const T*>::iterator _active;
+	struct Slot
+	{
+		const T      *member;     // NULL if the slot is free
+		unsigned int  cost;       // expected work in abstract units
+		bool          boost;
+		bool          granted;    // allowed to work in the current frame
+		int           prev;
+		int           next;       // ring of registered members or the free list
+	};
+
+	std::vector<Slot> _slots;
+	int          _active;      // the next member in round-robin order or -1
+	int          _boosted;     // where the next search for boosted members starts
+	int          _free;        // head of the free list or -1
+	size_t       _count;
+	unsigned int _budget;
+	float        _frameTime;
+
+	void BeginFrame(float time)
+	{
+		_frameTime = time;
+		if( -1 == _active )
+		{
+			return;
+		}
+
+		int i = _active;
+		do
+		{
+			_slots[i].granted = false;
+			i = _slots[i].next;
+		} while( i != _active );
+
+		// boosted members take turns using a half of the budget
+		unsigned int spent = 0;
+		int stop = _boosted;
+		do
+		{
+			Slot &s = _slots[_boosted];
+			if( s.boost )
+			{
+				if( spent + s.cost > _budget / 2 )
+					break;
+				s.granted = true;
+				spent += s.cost;
+			}
+			_boosted = s.next;
+		} while( _boosted != stop );
+
+		// the rest goes in round-robin order; at least one member works
+		// every frame even if it is over the budget
+		stop = _active;
+		do
+		{
+			Slot &s = _slots[_active];
+			if( !s.granted )
+			{
+				if( spent && spent + s.cost > _budget )
+					break;
+				s.granted = true;
+				spent += s.cost;
+			}
+			_active = s.next;
+		} while( _active != stop );
+	}
+
 public:
+	explicit JobManager(unsigned int budget)
+	  : _active(-1)
+	  , _boosted(-1)
+	  , _free(-1)
+	  , _count(0)
+	  , _budget(budget)
+	  , _frameTime(-1)
+	{
+	}
+
+	~JobManager()
+	{
+		assert(0 == _count);
+	}
 
-    ~JobManager()
+	int RegisterMember(const T *member, unsigned int cost = 1)
 	{
-		assert(_members.empty());
+		assert(member && cost > 0);
+
+		int ticket = _free;
+		if( -1 == ticket )
+		{
+			ticket = (int) _slots.size();
+			_slots.push_back(Slot());
+		}
+		else
+		{
+			_free = _slots[ticket].next;
+		}
+
+		Slot &s = _slots[ticket];
+		s.member = member;
+		s.cost = cost;
+		s.boost = false;
+		s.granted = false; // starts working from the next frame
+
+		if( -1 == _active )
+		{
+			s.prev = s.next = ticket;
+			_active = _boosted = ticket;
+		}
+		else
+		{
+			// insert just before the active one so it waits for the whole round
+			Slot &next = _slots[_active];
+			s.prev = next.prev;
+			s.next = _active;
+			_slots[next.prev].next = ticket;
+			next.prev = ticket;
+		}
+
+		++_count;
+		return ticket;
 	}
 
-	void RegisterMember(const T *member)
+	void UnregisterMember(int ticket)
 	{
-		assert(std::find(_members.begin(), _members.end(), member) == _members.end());
-		_members.push_back(member);
-		if( 1 == _members.size() )
-			_active = _members.begin();
+		assert(ticket >= 0 && ticket < (int) _slots.size() && _slots[ticket].member);
+
+		Slot &s = _slots[ticket];
+		if( s.next == ticket )
+		{
+			_active = _boosted = -1;
+		}
+		else
+		{
+			_slots[s.prev].next = s.next;
+			_slots[s.next].prev = s.prev;
+			if( _active == ticket )
+				_active = s.next;
+			if( _boosted == ticket )
+				_boosted = s.next;
+		}
+
+		s.member = NULL;
+		s.next = _free;
+		_free = ticket;
+		if( 0 == --_count )
+		{
+			_frameTime = -1; // the next level starts its time from zero
+		}
 	}
 
-	void UnregisterMember(const T *member)
+	void SetBoost(int ticket, bool boost)
 	{
-		assert(std::find(_members.begin(), _members.end(), member) != _members.end());
-		if( *_active == member )
-			++_active;
-		_members.remove(member);
-		if( _members.end() == _active )
-			_active = _members.begin();
+		assert(ticket >= 0 && ticket < (int) _slots.size() && _slots[ticket].member);
+		_slots[ticket].boost = boost;
 	}
 
-    bool TakeJob(const T *member)
+	// time identifies the frame; the first call in a frame distributes the budget
+	bool TakeJob(int ticket, float time)
 	{
-		if( *_active == member )
+		assert(ticket >= 0 && ticket < (int) _slots.size() && _slots[ticket].member);
+		if( time != _frameTime )
 		{
-			if( ++_active == _members.end() )
-				_active = _members.begin();
-			return true; // allow to work
+			BeginFrame(time);
 		}
-		return false;
+		return _slots[ticket].granted;
 	}
 };
 
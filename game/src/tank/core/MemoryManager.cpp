@@ -0,0 +1,59 @@
+// MemoryManager.cpp
+
+#include "stdafx.h"
+#include "MemoryManager.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+MemoryPoolBase *MemoryPoolBase::_first; // zero initialized before any pool is constructed
+int MemoryPoolBase::_retainCount;
+
+MemoryPoolBase::MemoryPoolBase()
+  : _next(_first)
+  , _prev(NULL)
+  , _liveCount(0)
+  , _peakCount(0)
+  , _blockCount(0)
+  , _emptyBlockCount(0)
+{
+	if( _first )
+		_first->_prev = this;
+	_first = this;
+}
+
+MemoryPoolBase::~MemoryPoolBase()
+{
+	if( _prev )
+		_prev->_next = _next;
+	else
+		_first = _next;
+	if( _next )
+		_next->_prev = _prev;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AllocationContext::AllocationContext()
+{
+	++MemoryPoolBase::_retainCount;
+}
+
+AllocationContext::~AllocationContext()
+{
+	assert(MemoryPoolBase::_retainCount > 0);
+	if( 0 == --MemoryPoolBase::_retainCount )
+	{
+		ReleaseEmptyBlocks();
+	}
+}
+
+void AllocationContext::ReleaseEmptyBlocks()
+{
+	for( MemoryPoolBase *pool = MemoryPoolBase::_first; pool; pool = pool->_next )
+	{
+		pool->ReleaseEmptyBlocks();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -5,13 +5,72 @@
 
 ///////////////////////////////////////////////////////////////////
 
+// common part of all pools: statistics and the list used to walk them
+class MemoryPoolBase
+{
+	static MemoryPoolBase *_first;
+	static int _retainCount;
+
+	MemoryPoolBase *_next;
+	MemoryPoolBase *_prev;
+
+	friend class AllocationContext;
+
+protected:
+	size_t _liveCount;
+	size_t _peakCount;
+	size_t _blockCount;
+	size_t _emptyBlockCount;
+
+	MemoryPoolBase();
+	virtual ~MemoryPoolBase();
+
+	// empty blocks are kept while any allocation context is alive, but no
+	// more than RETAIN_LIMIT bytes of them per pool
+	enum { RETAIN_LIMIT = 256 * 1024 };
+	static bool RetainEmptyBlock(size_t emptyBytes)
+	{
+		return _retainCount > 0 && emptyBytes <= RETAIN_LIMIT;
+	}
+
+public:
+	virtual const char* GetName() const = 0;
+	virtual size_t GetObjectSize() const = 0;
+	virtual void ReleaseEmptyBlocks() = 0;
+
+	size_t GetLiveCount() const { return _liveCount; }
+	size_t GetPeakCount() const { return _peakCount; }
+	size_t GetBlockCount() const { return _blockCount; }
+	size_t GetEmptyBlockCount() const { return _emptyBlockCount; }
+
+	static MemoryPoolBase* GetFirst() { return _first; }
+	MemoryPoolBase* GetNext() const { return _next; }
+};
+
+// scope of a match. the pools keep some of their empty blocks until the last
+// context is destroyed, so the objects of the next map reuse the memory of the
+// previous one instead of going through the heap block by block.
+class AllocationContext
+{
+	AllocationContext(const AllocationContext &);
+	AllocationContext& operator = (const AllocationContext &);
+
+public:
+	AllocationContext();
+	~AllocationContext();
+
+	void ReleaseEmptyBlocks(); // returns memory of all pools to the heap
+};
+
+///////////////////////////////////////////////////////////////////
+
 template
 <
 	class T,
 	size_t extra_bytes = 0,
 	size_t block_size = 128
 >
-class MemoryPool
+class MemoryPool : public MemoryPoolBase
 {
 	struct BlankObject
 	{
@@ -133,26 +192,36 @@ class MemoryPool
 
 
 	BlockPtr *_blocks;
-	size_t _blockCount;
+	size_t _blockSlots;
 	size_t _firstEmptyIdx;
 	Block *_freeBlock;
 
-
-#ifndef NDEBUG
-	size_t _allocatedCount;
-	size_t _allocatedPeak;
-#endif
+	void DeleteBlock(Block *block)
+	{
+		assert(0 == block->_used);
+
+		if( block == _freeBlock )
+			_freeBlock = _freeBlock->_nextFree;
+		if( block->_prevFree )
+			block->_prevFree->_nextFree = block->_nextFree;
+		if( block->_nextFree )
+			block->_nextFree->_prevFree = block->_prevFree;
+
+		_blocks[block->_thisBlockIdx]._block = NULL;
+		_blocks[block->_thisBlockIdx]._nextEmptyIdx = _firstEmptyIdx;
+		_firstEmptyIdx = block->_thisBlockIdx;
+
+		delete block;
+		--_blockCount;
+		--_emptyBlockCount;
+	}
 
 public:
 	MemoryPool()
 	  : _blocks((BlockPtr*) malloc(sizeof(BlockPtr)))
-	  , _blockCount(1)
+	  , _blockSlots(1)
 	  , _firstEmptyIdx(0)
 	  , _freeBlock(NULL)
-#		ifndef NDEBUG
-	  , _allocatedCount(0)
-	  , _allocatedPeak(0)
-#		endif
 	{
 		if( !_blocks )
 			throw std::bad_alloc();
@@ -162,39 +231,59 @@ public:
 
 	~MemoryPool()
 	{
+		ReleaseEmptyBlocks();
 #		ifndef NDEBUG
-			assert(0 == _allocatedCount);
-			for( size_t i = 0; i < _blockCount; ++i )
+			assert(0 == _liveCount);
+			for( size_t i = 0; i < _blockSlots; ++i )
 				assert(!_blocks[i]._block);
-			printf("MemoryPool<%s>: peak allocation is %u\n", typeid(T).name(), _allocatedPeak);
+			printf("MemoryPool<%s>: peak allocation is %u\n", GetName(), (unsigned int) _peakCount);
 #		endif
 		free(_blocks);
 	}
 
+	virtual const char* GetName() const
+	{
+		return typeid(T).name();
+	}
+
+	virtual size_t GetObjectSize() const
+	{
+		return sizeof(T) + extra_bytes;
+	}
+
+	virtual void ReleaseEmptyBlocks()
+	{
+		for( size_t i = 0; i < _blockSlots; ++i )
+		{
+			if( _blocks[i]._block && 0 == _blocks[i]._block->_used )
+				DeleteBlock(_blocks[i]._block);
+		}
+	}
+
 	void* Alloc()
 	{
-#		ifndef NDEBUG
-			if( ++_allocatedCount > _allocatedPeak )
-				_allocatedPeak = _allocatedCount;
-#		endif
+		if( ++_liveCount > _peakCount )
+			_peakCount = _liveCount;
 
 		if( !_freeBlock )
 		{
 			// grow if no empty blocks available
-			if( _firstEmptyIdx == _blockCount )
+			if( _firstEmptyIdx == _blockSlots )
 			{
-				_blocks = (BlockPtr *) realloc(_blocks, sizeof(BlockPtr) * _blockCount * 2);
+				_blocks = (BlockPtr *) realloc(_blocks, sizeof(BlockPtr) * _blockSlots * 2);
 				if( !_blocks )
 					throw std::bad_alloc();
-				for( size_t i = _blockCount; i < _blockCount * 2; ++i )
+				for( size_t i = _blockSlots; i < _blockSlots * 2; ++i )
 				{
 					_blocks[i]._block = NULL;
 					_blocks[i]._nextEmptyIdx = i + 1; // last is out of range
 				}
-				_blockCount *= 2;
+				_blockSlots *= 2;
 			}
 
 			_freeBlock = new Block(_firstEmptyIdx);
+			++_blockCount;
+			++_emptyBlockCount;
 
 			size_t tmp = _firstEmptyIdx;
 			_firstEmptyIdx = _blocks[tmp]._nextEmptyIdx;
@@ -206,6 +295,9 @@ public:
 #			endif
 		}
 
+		if( 0 == _freeBlock->_used )
+			--_emptyBlockCount;
+
 		BlankObject *result = _freeBlock->Alloc();
 		assert(_freeBlock == result->_block);
 
@@ -225,7 +317,8 @@ public:
 
 	void Free(void* p)
 	{
-		assert(_allocatedCount--);
+		assert(_liveCount > 0);
+		--_liveCount;
 
 		Block *block = ((BlankObject*) p)->_block;
 		if( !block->_firstFreeBlank )
@@ -247,20 +340,11 @@ public:
 
 		if( 0 == block->_used )
 		{
-			// free unused block
-
-			if( block == _freeBlock )
-				_freeBlock = _freeBlock->_nextFree;
-			if( block->_prevFree )
-				block->_prevFree->_nextFree = block->_nextFree;
-			if( block->_nextFree )
-				block->_nextFree->_prevFree = block->_prevFree;
-
-			_blocks[block->_thisBlockIdx]._block = NULL;
-			_blocks[block->_thisBlockIdx]._nextEmptyIdx = _firstEmptyIdx;
-			_firstEmptyIdx = block->_thisBlockIdx;
-
-			delete block;
+			++_emptyBlockCount;
+			if( !RetainEmptyBlock(_emptyBlockCount * sizeof(Block)) )
+			{
+				DeleteBlock(block);
+			}
 		}
 	}
 
@@ -47,6 +47,144 @@ void CounterBase::Push(float value)
 		INVOKE(_callback)(value);
 }
 
+///////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+	enum { TRACE_SIZE = 16384 }; // events kept per thread
+
+	struct TraceEvent
+	{
+		const ProfileTag *tag;
+		LONGLONG begin;
+		LONGLONG end;
+	};
+
+	struct ThreadTrace
+	{
+		DWORD threadId;
+		volatile LONG count;  // total number of events ever recorded, wraps around
+		ThreadTrace *next;
+		TraceEvent events[TRACE_SIZE];
+	};
+
+	class TraceRegistry
+	{
+	public:
+		CRITICAL_SECTION cs;
+		ThreadTrace *first;
+		LARGE_INTEGER start;
+		LARGE_INTEGER frequency;
+
+		TraceRegistry()
+		  : first(NULL)
+		{
+			InitializeCriticalSection(&cs);
+			QueryPerformanceFrequency(&frequency);
+			QueryPerformanceCounter(&start);
+		}
+
+		~TraceRegistry()
+		{
+			while( first )
+			{
+				ThreadTrace *tmp = first;
+				first = first->next;
+				delete tmp;
+			}
+			DeleteCriticalSection(&cs);
+		}
+	};
+
+	TraceRegistry g_traces;
+	__declspec(thread) ThreadTrace *t_trace;
+
+	ThreadTrace* GetThreadTrace()
+	{
+		if( !t_trace )
+		{
+			t_trace = new ThreadTrace();
+			t_trace->threadId = GetCurrentThreadId();
+			t_trace->count = 0;
+			EnterCriticalSection(&g_traces.cs);
+			t_trace->next = g_traces.first;
+			g_traces.first = t_trace;
+			LeaveCriticalSection(&g_traces.cs);
+		}
+		return t_trace;
+	}
+}
+
+ProfileTag *ProfileTag::s_first;
+
+ProfileTag::ProfileTag(const char *name)
+  : CounterBase(name, name)
+  , _name(name)
+  , _frameTicks(0)
+  , _next(s_first)
+{
+	s_first = this;
+}
+
+void ProfileTag::FlushFrame()
+{
+	for( ProfileTag *tag = s_first; tag; tag = tag->_next )
+	{
+		tag->Push((float) tag->_frameTicks / (float) g_traces.frequency.QuadPart);
+		tag->_frameTicks = 0;
+	}
+}
+
+ProfileScope::ProfileScope(ProfileTag &tag)
+  : _tag(tag)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	_begin = now.QuadPart;
+}
+
+ProfileScope::~ProfileScope()
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	_tag.AddTicks(now.QuadPart - _begin);
+
+	ThreadTrace *trace = GetThreadTrace();
+	TraceEvent &e = trace->events[(unsigned long) trace->count % TRACE_SIZE];
+	e.tag = &_tag;
+	e.begin = _begin;
+	e.end = now.QuadPart;
+	InterlockedIncrement(&trace->count);
+}
+
+size_t ProfileScope::DumpTrace(std::ostream &out)
+{
+	const double usec = 1e6 / (double) g_traces.frequency.QuadPart;
+	size_t result = 0;
+
+	out.setf(std::ios::fixed);
+	out.precision(3);
+	out << "{\"traceEvents\":[";
+	EnterCriticalSection(&g_traces.cs);
+	for( const ThreadTrace *trace = g_traces.first; trace; trace = trace->next )
+	{
+		// other threads keep recording; the oldest of the dumped events may be torn
+		unsigned long count = (unsigned long) trace->count;
+		for( unsigned long i = count > TRACE_SIZE ? count - TRACE_SIZE : 0; i != count; ++i )
+		{
+			const TraceEvent &e = trace->events[i % TRACE_SIZE];
+			out << (result++ ? ",\n" : "\n")
+			    << "{\"name\":\"" << e.tag->GetName() << "\",\"ph\":\"X\""
+			    << ",\"ts\":" << (double) (e.begin - g_traces.start.QuadPart) * usec
+			    << ",\"dur\":" << (double) (e.end - e.begin) * usec
+			    << ",\"pid\":1,\"tid\":" << trace->threadId << "}";
+		}
+	}
+	LeaveCriticalSection(&g_traces.cs);
+	out << "\n]}\n";
+
+	return result;
+}
 
+///////////////////////////////////////////////////////////////////////////////
 // end of file
@@ -31,4 +31,59 @@ private:
 	static std::vector<CounterInfoEx>& GetRegisteredCountersStatic();
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// scope timing. every scope leaves an event in the ring buffer of its thread,
+// nested scopes are told apart by time; DumpTrace writes the recent events in
+// the Chrome trace_event format. a tag is also a counter that receives the
+// total time of its scopes in the last frame, in seconds.
+//
+// PROFILE_TAG(tagStep, "Level::Step");  // file scope
+// PROFILE_SCOPE(tagStep);               // function body
+//
+// both macros expand to nothing unless PROFILE_SCOPES is defined
+
+class ProfileTag : public CounterBase
+{
+public:
+	explicit ProfileTag(const char *name);
+
+	const char* GetName() const { return _name; }
+	void AddTicks(LONGLONG ticks) { _frameTicks += ticks; } // not atomic; counters are for the main thread
+
+	// pushes the accumulated time of every tag to the counters; once per frame
+	static void FlushFrame();
+
+private:
+	const char *_name;
+	LONGLONG _frameTicks;
+	ProfileTag *_next;
+
+	static ProfileTag *s_first;
+};
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(ProfileTag &tag);
+	~ProfileScope();
+
+	// writes events of all threads; returns the number of events written
+	static size_t DumpTrace(std::ostream &out);
+
+private:
+	ProfileTag &_tag;
+	LONGLONG _begin;
+
+	ProfileScope(const ProfileScope&);
+	ProfileScope& operator = (const ProfileScope&);
+};
+
+#ifdef PROFILE_SCOPES
+# define PROFILE_TAG(var, name) static ProfileTag var(name)
+# define PROFILE_SCOPE(var)     ProfileScope var##Scope(var)
+#else
+# define PROFILE_TAG(var, name)
+# define PROFILE_SCOPE(var)
+#endif
+
 // end of file
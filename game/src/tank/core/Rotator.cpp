@@ -2,6 +2,7 @@
 
 #include "stdafx.h"
 #include "rotator.h"
+#include "DetMath.h"
 
 #include "fs/SaveFile.h"
 
@@ -119,7 +120,7 @@ bool Rotator::process_dt(float dt)
 				}
 				else
 				{
-					_rCurrent += (_accel_current*powf(_accel_stop * dt + _velocity_current, 2) -
+					_rCurrent += (_accel_current*Square(_accel_stop * dt + _velocity_current) -
 						_accel_stop * _velocity_current * _velocity_current) /
 						(2.0f * _accel_stop * _accel_stop);
 					_velocity_current = new_v;
@@ -137,7 +138,7 @@ bool Rotator::process_dt(float dt)
 			if( new_v > _velocity_limit )
 			{
 				_rCurrent += (_accel_current * dt * _velocity_limit -
-					0.5f * powf(_velocity_current - _velocity_limit,2)) / _accel_current;
+					0.5f * Square(_velocity_current - _velocity_limit)) / _accel_current;
 
 				_velocity_current = _velocity_limit;
 			}
@@ -164,7 +165,7 @@ bool Rotator::process_dt(float dt)
 				else
 				{
 					_rCurrent += (_accel_stop * _velocity_current * _velocity_current -
-						_accel_current*powf(_velocity_current - _accel_stop * dt, 2)) /
+						_accel_current*Square(_velocity_current - _accel_stop * dt)) /
 						(-2.0f * _accel_stop * _accel_stop);
 					_velocity_current = new_v;
 				}
@@ -180,7 +181,7 @@ bool Rotator::process_dt(float dt)
 			float new_v = _velocity_current - dt * _accel_current;
 			if( new_v < -_velocity_limit )
 			{
-				_rCurrent += (0.5f * powf(_velocity_current + _velocity_limit,2) -
+				_rCurrent += (0.5f * Square(_velocity_current + _velocity_limit) -
 					_accel_current * dt * _velocity_limit) / _accel_current;
 
 				_velocity_current = -_velocity_limit;
@@ -367,7 +368,7 @@ void Rotator::ga_t1(float t, float ac, float as, float vl, float xt)
 	float t3 = (as*((vc - vl)*(vc - vl) + 2*ac*(-xc + xt)) - ac*vl*vl)/(2.0f*ac*as*vl);
 	if( t <= t3 )
 	{
-		float new_xc = (vl*vl/as + (as*powf((vc - vl)*(vc - vl) - 2*ac*(t*vl + xc - xt),2))/
+		float new_xc = (vl*vl/as + (as*Square((vc - vl)*(vc - vl) - 2*ac*(t*vl + xc - xt)))/
 			(ac*ac*vl*vl) + (-2*(vc - vl)*(vc - vl) + 4*ac*(t*vl + xc + xt))/ac)/8.0f;
 		vc = (4*vl - (4*as*((vc - vl)*(vc - vl) - 2*ac*(t*vl + xc - xt)))/(ac*vl))/8.0f;
 		xc = new_xc;
@@ -389,9 +390,9 @@ void Rotator::ga_t2(float t, float ac, float as, float xt)
 	// acceleration phase
 	float t1;
 	if( ac - as > 0 && as < 0 )
-		t1 = ((-vc + sqrtf((as*(2*ac*(xc - xt) - (vc*vc)))/(ac - as)))/ac);
+		t1 = ((-vc + DetSqrt((as*(2*ac*(xc - xt) - (vc*vc)))/(ac - as)))/ac);
 	else
-		t1 = ((-vc - sqrtf((as*(2*ac*(xc - xt) - (vc*vc)))/(ac - as)))/ac);
+		t1 = ((-vc - DetSqrt((as*(2*ac*(xc - xt) - (vc*vc)))/(ac - as)))/ac);
 	if( t <= t1 )
 	{
 		xc = (ac * t*t) * 0.5f + t*vc + xc;
@@ -402,15 +403,15 @@ void Rotator::ga_t2(float t, float ac, float as, float xt)
 	// slowdown phase
 	float t2;
 	if( ac - as > 0 && as < 0 )
-		t2 = ((-vc + sqrt(((ac - as)*(2*ac*(xc - xt) - (vc*vc)))/as))/ac);
+		t2 = ((-vc + DetSqrt(((ac - as)*(2*ac*(xc - xt) - (vc*vc)))/as))/ac);
 	else
-		t2 = ((-vc - sqrt(((ac - as)*(2*ac*(xc - xt) - (vc*vc)))/as))/ac);
+		t2 = ((-vc - DetSqrt(((ac - as)*(2*ac*(xc - xt) - (vc*vc)))/as))/ac);
 	if( t <= t2 )
 	{
 		float new_xc = ((ac*ac)*as*(t*t) + 2*ac*as*t*vc - ac*(vc*vc) + 2*as*(vc*vc) +
-			2*(ac*ac)*xc - 2*ac*as*xc + 2*(ac*t + vc)*sqrtf((ac - as)*as*(2*ac*(xc - xt) -
+			2*(ac*ac)*xc - 2*ac*as*xc + 2*(ac*t + vc)*DetSqrt((ac - as)*as*(2*ac*(xc - xt) -
 			(vc*vc))) + 2*ac*as*xt)/(2.0f*(ac*ac));
-		vc = (ac*as*t + as*vc + sqrtf((ac - as)*as*(2*ac*xc - 2*ac*xt - vc*vc)))/ac;
+		vc = (ac*as*t + as*vc + DetSqrt((ac - as)*as*(2*ac*xc - 2*ac*xt - vc*vc)))/ac;
 		xc = new_xc;
 		return;
 	}
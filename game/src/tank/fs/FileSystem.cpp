@@ -119,6 +119,19 @@ void FileSystem::EnumAllFiles(std::set<string_t> &files, const string_t &mask)
 	// base file system can't contain any files
 }
 
+void FileSystem::EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask)
+{
+	// fallback for file systems which know only names
+	std::set<string_t> names;
+	EnumAllFiles(names, mask);
+	files.clear();
+	FileInfo unknown = {0};
+	for( std::set<string_t>::const_iterator it = names.begin(); it != names.end(); ++it )
+	{
+		files.insert(files.end(), std::make_pair(*it, unknown));
+	}
+}
+
 SafePtr<File> FileSystem::RawOpen(const string_t &fileName, FileMode mode)
 {
 	throw std::runtime_error("Base file system can't contain any files");
@@ -157,6 +170,8 @@ SafePtr<FileSystem> FileSystem::GetFileSystem(const string_t &path, bool create,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef _WIN32
+
 OSFileSystem::OSFile::OSFile(const string_t &fileName, FileMode mode)
   : _mode(mode)
   , _mapped(false)
@@ -486,6 +501,35 @@ void OSFileSystem::EnumAllFiles(std::set<string_t> &files, const string_t &mask)
 	}
 }
 
+void OSFileSystem::EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask)
+{
+	// FindFirstFile does not depend on the current directory when given a full path
+	WIN32_FIND_DATA fd;
+	HANDLE hSearch = FindFirstFile((_rootDirectory + TEXT('\\') + mask).c_str(), &fd);
+	files.clear();
+	if( INVALID_HANDLE_VALUE == hSearch )
+	{
+		if( ERROR_FILE_NOT_FOUND == GetLastError() )
+		{
+			return; // nothing matches
+		}
+		throw std::runtime_error(StrFromErr(GetLastError()));
+	}
+
+	do
+	{
+		if( 0 == (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) )
+		{
+			FileInfo &info = files[fd.cFileName];
+			info.size = ((unsigned long long) fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+			info.stamp = ((unsigned long long) fd.ftLastWriteTime.dwHighDateTime << 32)
+				| fd.ftLastWriteTime.dwLowDateTime;
+		}
+	}
+	while( FindNextFile(hSearch, &fd) );
+	FindClose(hSearch);
+}
+
 SafePtr<File> OSFileSystem::RawOpen(const string_t &fileName, FileMode mode)
 {
 	// combine with the root path
@@ -553,6 +597,586 @@ SafePtr<FileSystem> OSFileSystem::GetFileSystem(const string_t &path, bool creat
 	return NULL;
 }
 
+#else // POSIX
+
+static const size_t STREAM_BUFFER_SIZE = 65536;
+
+static string_t StrFromErrno(int err)
+{
+	return strerror(err);
+}
+
+// names are looked up ignoring case as on Windows: if the exact name does not
+// exist, the first directory entry that differs only by case is used instead
+static string_t FoldCase(const string_t &dir, const string_t &name)
+{
+	struct stat st;
+	if( 0 == stat((dir + '/' + name).c_str(), &st) )
+	{
+		return name;
+	}
+
+	string_t result = name;
+	if( DIR *d = opendir(dir.c_str()) )
+	{
+		while( const dirent *entry = readdir(d) )
+		{
+			if( 0 == strcasecmp(entry->d_name, name.c_str()) )
+			{
+				result = entry->d_name;
+				break;
+			}
+		}
+		closedir(d);
+	}
+	return result;
+}
+
+OSFileSystem::OSFile::OSFile(const string_t &fileName, FileMode mode)
+  : _mode(mode)
+  , _mapped(false)
+  , _streamed(false)
+{
+	assert(_mode);
+
+	int flags;
+	if( _mode & ModeWrite )
+	{
+		flags = (_mode & ModeRead) ? (O_RDWR | O_CREAT) : (O_WRONLY | O_CREAT | O_TRUNC);
+	}
+	else
+	{
+		flags = O_RDONLY;
+	}
+
+	_file.fd = open(fileName.c_str(), flags | O_CLOEXEC, 0644);
+	if( -1 == _file.fd )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+
+	posix_fadvise(_file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+OSFileSystem::OSFile::~OSFile()
+{
+}
+
+SafePtr<MemMap> OSFileSystem::OSFile::QueryMap()
+{
+	assert(!_mapped && !_streamed);
+	SafePtr<MemMap> result(new OSMemMap(this, _file.fd));
+	_mapped = true;
+	return result;
+}
+
+SafePtr<Stream> OSFileSystem::OSFile::QueryStream()
+{
+	assert(!_mapped && !_streamed);
+	SafePtr<Stream> result;
+	if( _mode & ModeWrite )
+		result = new OSStream(this, _file.fd);
+	else
+		result = new OSMappedStream(this, _file.fd);
+	_streamed = true;
+	return result;
+}
+
+void OSFileSystem::OSFile::Unmap()
+{
+	assert(_mapped && !_streamed);
+	_mapped = false;
+}
+
+void OSFileSystem::OSFile::Unstream()
+{
+	assert(_streamed && !_mapped);
+	_streamed = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OSFileSystem::OSFile::OSStream::OSStream(const SafePtr<File> &parent, int fd)
+  : Stream(parent)
+  , _fd(fd)
+  , _buffer(STREAM_BUFFER_SIZE)
+  , _bufferOffset(0)
+  , _bufferPos(0)
+  , _bufferLen(0)
+  , _dirty(false)
+{
+}
+
+OSFileSystem::OSFile::OSStream::~OSStream()
+{
+	try
+	{
+		Sync();
+	}
+	catch( const std::exception & )
+	{
+		// nothing we can do here; the data is lost
+		assert(false);
+	}
+}
+
+void OSFileSystem::OSFile::OSStream::Sync()
+{
+	if( _dirty )
+	{
+		size_t written = 0;
+		while( written < _bufferLen )
+		{
+			ssize_t result = pwrite(_fd, &_buffer[written], _bufferLen - written, _bufferOffset + written);
+			if( result < 0 )
+			{
+				if( EINTR == errno )
+					continue;
+				throw std::runtime_error(StrFromErrno(errno));
+			}
+			written += result;
+		}
+		_dirty = false;
+	}
+	_bufferOffset += _bufferPos;
+	_bufferPos = 0;
+	_bufferLen = 0;
+}
+
+bool OSFileSystem::OSFile::OSStream::IsEof()
+{
+	if( _bufferPos < _bufferLen )
+	{
+		return false;
+	}
+	return _bufferOffset + _bufferPos >= GetSize();
+}
+
+unsigned long OSFileSystem::OSFile::OSStream::Read(void *dst, unsigned long blockSize, unsigned long numBlocks)
+{
+	if( _dirty )
+	{
+		Sync();
+	}
+
+	char *out = (char *) dst;
+	size_t total = blockSize * numBlocks;
+	size_t done = 0;
+
+	while( done < total )
+	{
+		if( _bufferPos == _bufferLen )
+		{
+			Sync();
+
+			// large reads bypass the buffer
+			bool direct = total - done >= _buffer.size();
+			ssize_t result = direct ?
+				pread(_fd, out + done, total - done, _bufferOffset) :
+				pread(_fd, &_buffer[0], _buffer.size(), _bufferOffset);
+			if( result < 0 )
+			{
+				if( EINTR == errno )
+					continue;
+				throw std::runtime_error(StrFromErrno(errno));
+			}
+			if( 0 == result )
+			{
+				break; // end of file
+			}
+
+			if( direct )
+			{
+				_bufferOffset += result;
+				done += result;
+				continue;
+			}
+			_bufferLen = result;
+		}
+
+		size_t chunk = std::min(total - done, _bufferLen - _bufferPos);
+		memcpy(out + done, &_buffer[_bufferPos], chunk);
+		_bufferPos += chunk;
+		done += chunk;
+	}
+
+	if( done % blockSize )
+	{
+		throw std::runtime_error("unexpected end of file");
+	}
+	return done / blockSize;
+}
+
+void OSFileSystem::OSFile::OSStream::Write(const void *src, unsigned long byteCount)
+{
+	if( !_dirty || _bufferLen + byteCount > _buffer.size() )
+	{
+		Sync();
+	}
+
+	if( byteCount >= _buffer.size() )
+	{
+		// large writes bypass the buffer
+		size_t written = 0;
+		while( written < byteCount )
+		{
+			ssize_t result = pwrite(_fd, (const char *) src + written, byteCount - written, _bufferOffset + written);
+			if( result < 0 )
+			{
+				if( EINTR == errno )
+					continue;
+				throw std::runtime_error(StrFromErrno(errno));
+			}
+			written += result;
+		}
+		_bufferOffset += byteCount;
+		return;
+	}
+
+	memcpy(&_buffer[_bufferLen], src, byteCount);
+	_bufferLen += byteCount;
+	_bufferPos = _bufferLen;
+	_dirty = true;
+}
+
+unsigned long long OSFileSystem::OSFile::OSStream::Seek(long long amount, unsigned int origin)
+{
+	long long target;
+	switch( origin )
+	{
+	case SEEK_SET: target = amount; break;
+	case SEEK_CUR: target = (long long) (_bufferOffset + _bufferPos) + amount; break;
+	case SEEK_END: target = (long long) GetSize() + amount; break;
+	default:
+		assert(false);
+		target = amount;
+	}
+	if( target < 0 )
+	{
+		throw std::runtime_error(StrFromErrno(EINVAL));
+	}
+
+	// seeking inside the read-ahead window keeps the buffer
+	if( !_dirty && (unsigned long long) target >= _bufferOffset
+		&& (unsigned long long) target <= _bufferOffset + _bufferLen )
+	{
+		_bufferPos = (size_t) (target - _bufferOffset);
+		return target;
+	}
+
+	Sync();
+	_bufferOffset = target;
+	return target;
+}
+
+unsigned long long OSFileSystem::OSFile::OSStream::GetSize()
+{
+	struct stat st;
+	if( fstat(_fd, &st) )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+	unsigned long long size = st.st_size;
+	if( _dirty )
+	{
+		size = std::max(size, _bufferOffset + _bufferLen);
+	}
+	return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OSFileSystem::OSFile::OSMappedStream::OSMappedStream(const SafePtr<File> &parent, int fd)
+  : Stream(parent)
+  , _data(NULL)
+  , _size(0)
+  , _pos(0)
+{
+	struct stat st;
+	if( fstat(fd, &st) )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+	_size = st.st_size;
+
+	if( _size ) // empty files can't be mapped
+	{
+		void *data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if( MAP_FAILED == data )
+		{
+			throw std::runtime_error(StrFromErrno(errno));
+		}
+		madvise(data, _size, MADV_SEQUENTIAL);
+		_data = (const char *) data;
+	}
+}
+
+OSFileSystem::OSFile::OSMappedStream::~OSMappedStream()
+{
+	if( _data )
+	{
+		munmap((void *) _data, _size);
+	}
+}
+
+bool OSFileSystem::OSFile::OSMappedStream::IsEof()
+{
+	return _pos >= _size;
+}
+
+unsigned long OSFileSystem::OSFile::OSMappedStream::Read(void *dst, unsigned long blockSize, unsigned long numBlocks)
+{
+	unsigned long long avail = _pos < _size ? _size - _pos : 0;
+	size_t bytesRead = (size_t) std::min(avail, (unsigned long long) blockSize * numBlocks);
+	memcpy(dst, _data + _pos, bytesRead);
+	_pos += bytesRead;
+	if( bytesRead % blockSize )
+	{
+		throw std::runtime_error("unexpected end of file");
+	}
+	return bytesRead / blockSize;
+}
+
+void OSFileSystem::OSFile::OSMappedStream::Write(const void *src, unsigned long byteCount)
+{
+	throw std::runtime_error(StrFromErrno(EBADF));
+}
+
+unsigned long long OSFileSystem::OSFile::OSMappedStream::Seek(long long amount, unsigned int origin)
+{
+	long long target;
+	switch( origin )
+	{
+	case SEEK_SET: target = amount; break;
+	case SEEK_CUR: target = (long long) _pos + amount; break;
+	case SEEK_END: target = (long long) _size + amount; break;
+	default:
+		assert(false);
+		target = amount;
+	}
+	if( target < 0 )
+	{
+		throw std::runtime_error(StrFromErrno(EINVAL));
+	}
+	_pos = target;
+	return _pos;
+}
+
+unsigned long long OSFileSystem::OSFile::OSMappedStream::GetSize()
+{
+	return _size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OSFileSystem::OSFile::OSMemMap::OSMemMap(const SafePtr<File> &parent, int fd)
+  : MemMap(parent)
+  , _fd(fd)
+  , _data(NULL)
+  , _size(0)
+{
+	SetupMapping();
+}
+
+OSFileSystem::OSFile::OSMemMap::~OSMemMap()
+{
+	if( _data )
+	{
+		munmap(_data, _size);
+	}
+}
+
+void OSFileSystem::OSFile::OSMemMap::SetupMapping()
+{
+	struct stat st;
+	if( fstat(_fd, &st) )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+	_size = st.st_size;
+
+	if( _size ) // empty files can't be mapped
+	{
+		_data = mmap(NULL, _size, PROT_READ, MAP_SHARED, _fd, 0);
+		if( MAP_FAILED == _data )
+		{
+			_data = NULL;
+			throw std::runtime_error(StrFromErrno(errno));
+		}
+	}
+}
+
+char* OSFileSystem::OSFile::OSMemMap::GetData()
+{
+	return (char *) _data;
+}
+
+unsigned long OSFileSystem::OSFile::OSMemMap::GetSize() const
+{
+	return _size;
+}
+
+void OSFileSystem::OSFile::OSMemMap::SetSize(unsigned long size)
+{
+	if( _data )
+	{
+		munmap(_data, _size);
+		_data = NULL;
+	}
+	_size = 0;
+
+	if( ftruncate(_fd, size) )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+
+	SetupMapping();
+	assert(_size == size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SafePtr<OSFileSystem> OSFileSystem::Create(const string_t &rootDirectory, const string_t &nodeName)
+{
+	return new OSFileSystem(rootDirectory, nodeName);
+}
+
+OSFileSystem::OSFileSystem(const string_t &rootDirectory, const string_t &nodeName)
+  : FileSystem(nodeName)
+{
+	if( char *path = realpath(rootDirectory.c_str(), NULL) )
+	{
+		_rootDirectory = path;
+		free(path);
+	}
+	else
+	{
+		// error: nodeName doesn't exists or something nasty happened
+	}
+}
+
+OSFileSystem::OSFileSystem(OSFileSystem *parent, const string_t &nodeName)
+  : FileSystem(nodeName)
+{
+	assert(parent);
+	assert(string_t::npos == nodeName.find(DELIMITER));
+
+	MountTo(parent);
+	_rootDirectory = parent->_rootDirectory + DELIMITER + nodeName;
+}
+
+OSFileSystem::~OSFileSystem(void)
+{
+}
+
+bool OSFileSystem::IsValid() const
+{
+	return true;
+}
+
+void OSFileSystem::EnumAllFiles(std::set<string_t> &files, const string_t &mask)
+{
+	DIR *dir = opendir(_rootDirectory.c_str());
+	if( NULL == dir )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+
+	files.clear();
+	while( const dirent *entry = readdir(dir) )
+	{
+		if( fnmatch(mask.c_str(), entry->d_name, FNM_CASEFOLD) )
+		{
+			continue;
+		}
+		struct stat st;
+		if( 0 == fstatat(dirfd(dir), entry->d_name, &st, 0) && S_ISREG(st.st_mode) )
+		{
+			files.insert(entry->d_name);
+		}
+	}
+	closedir(dir);
+}
+
+void OSFileSystem::EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask)
+{
+	DIR *dir = opendir(_rootDirectory.c_str());
+	if( NULL == dir )
+	{
+		throw std::runtime_error(StrFromErrno(errno));
+	}
+
+	files.clear();
+	while( const dirent *entry = readdir(dir) )
+	{
+		if( fnmatch(mask.c_str(), entry->d_name, FNM_CASEFOLD) )
+		{
+			continue;
+		}
+		struct stat st;
+		if( 0 == fstatat(dirfd(dir), entry->d_name, &st, 0) && S_ISREG(st.st_mode) )
+		{
+			FileInfo &info = files[entry->d_name];
+			info.size = st.st_size;
+			info.stamp = (unsigned long long) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+		}
+	}
+	closedir(dir);
+}
+
+SafePtr<File> OSFileSystem::RawOpen(const string_t &fileName, FileMode mode)
+{
+	// combine with the root path
+	return new OSFile(_rootDirectory + DELIMITER + FoldCase(_rootDirectory, fileName), mode);
+}
+
+SafePtr<FileSystem> OSFileSystem::GetFileSystem(const string_t &path, bool create, bool nothrow)
+{
+	if( SafePtr<FileSystem> tmp = FileSystem::GetFileSystem(path, create, true) )
+	{
+		return tmp;
+	}
+
+	assert(!path.empty());
+
+	// skip delimiters at the beginning
+	string_t::size_type offset = 0;
+	while( offset < path.length() && path[offset] == DELIMITER )
+		++offset;
+	assert(path.length() > offset);
+
+	string_t::size_type p = path.find(DELIMITER, offset);
+	string_t dirName = FoldCase(_rootDirectory, path.substr(offset, string_t::npos != p ? p - offset : p));
+	string_t tmpDir = _rootDirectory + DELIMITER + dirName;
+
+	// try to find directory
+	struct stat st;
+	if( stat(tmpDir.c_str(), &st) )
+	{
+		if( !create || mkdir(tmpDir.c_str(), 0755) || stat(tmpDir.c_str(), &st) )
+		{
+			if( nothrow )
+				return NULL;
+			else
+				throw std::runtime_error("could not create or find directory");
+		}
+	}
+
+	if( S_ISDIR(st.st_mode) )
+	{
+		SafePtr<FileSystem> child(new OSFileSystem(this, dirName));
+		if( string_t::npos != p )
+			return child->GetFileSystem(path.substr(p), create, nothrow); // process the rest of the path
+		return child; // last path node was processed
+	}
+
+	if( !nothrow )
+		throw std::runtime_error("object is not a directory");
+	return NULL;
+}
+
+#endif // _WIN32
+
 ///////////////////////////////////////////////////////////////////////////////
 } // end of namespace FS
 ///////////////////////////////////////////////////////////////////////////////
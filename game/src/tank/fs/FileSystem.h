@@ -14,6 +14,12 @@ enum FileMode
 
 class File;
 
+struct FileInfo
+{
+	unsigned long long size;
+	unsigned long long stamp; // last write time in file system specific units; compare for equality only
+};
+
 class MemMap : public RefCounted
 {
 public:
@@ -96,6 +102,7 @@ public:
 
 	virtual bool IsValid() const;
 	virtual void EnumAllFiles(std::set<string_t> &files, const string_t &mask);
+	virtual void EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask);
 	SafePtr<File> Open(const string_t &path, FileMode mode = ModeRead);
 
 	static SafePtr<FileSystem> Create(const string_t &nodeName = TEXT(""));
@@ -105,6 +112,7 @@ public:
 
 class OSFileSystem : public FileSystem
 {
+#ifdef _WIN32
 	struct AutoHandle
 	{
 		HANDLE h;
@@ -120,6 +128,23 @@ class OSFileSystem : public FileSystem
 		AutoHandle(const AutoHandle&);
 		AutoHandle& operator = (const AutoHandle&);
 	};
+#else
+	struct AutoHandle
+	{
+		int fd;
+		AutoHandle() : fd(-1) {}
+		~AutoHandle()
+		{
+			if( -1 != fd )
+			{
+				close(fd);
+			}
+		}
+	private:
+		AutoHandle(const AutoHandle&);
+		AutoHandle& operator = (const AutoHandle&);
+	};
+#endif
 
 	class OSFile : public File
 	{
@@ -134,6 +159,7 @@ class OSFileSystem : public FileSystem
 		virtual void Unstream();
 
 	private:
+#ifdef _WIN32
 		class OSMemMap : public MemMap
 		{
 		public:
@@ -166,6 +192,66 @@ class OSFileSystem : public FileSystem
 		private:
 			HANDLE _hFile;
 		};
+#else
+		class OSMemMap : public MemMap
+		{
+		public:
+			OSMemMap(const SafePtr<File> &parent, int fd);
+			virtual ~OSMemMap();
+
+			virtual char* GetData();
+			virtual unsigned long GetSize() const;
+			virtual void SetSize(unsigned long size); // may invalidate pointer returned by GetData()
+
+		private:
+			int _fd;
+			void *_data;
+			unsigned long _size;
+			void SetupMapping();
+		};
+
+		// buffered stream; used for files opened for writing
+		class OSStream : public Stream
+		{
+		public:
+			OSStream(const SafePtr<File> &parent, int fd);
+			virtual ~OSStream();
+
+			virtual bool IsEof();
+			virtual unsigned long Read(void *dst, unsigned long byteCount, unsigned long numBlocks);
+			virtual void Write(const void *src, unsigned long byteCount);
+			virtual unsigned long long Seek(long long amount, unsigned int origin);
+			virtual unsigned long long GetSize();
+
+		private:
+			int _fd;
+			std::vector<char> _buffer;
+			unsigned long long _bufferOffset; // file position of the first byte in the buffer
+			size_t _bufferPos;                // current position inside the buffer
+			size_t _bufferLen;                // number of valid bytes in the buffer
+			bool _dirty;                      // buffer holds data not yet written to the file
+			void Sync(); // write pending data or drop read-ahead; leaves the buffer empty
+		};
+
+		// read-only stream over a private mapping; makes no system calls after open
+		class OSMappedStream : public Stream
+		{
+		public:
+			OSMappedStream(const SafePtr<File> &parent, int fd);
+			virtual ~OSMappedStream();
+
+			virtual bool IsEof();
+			virtual unsigned long Read(void *dst, unsigned long byteCount, unsigned long numBlocks);
+			virtual void Write(const void *src, unsigned long byteCount);
+			virtual unsigned long long Seek(long long amount, unsigned int origin);
+			virtual unsigned long long GetSize();
+
+		private:
+			const char *_data;
+			unsigned long long _size;
+			unsigned long long _pos;
+		};
+#endif
 
 	private:
 		AutoHandle _file;
@@ -189,6 +275,7 @@ public:
 	virtual SafePtr<FileSystem> GetFileSystem(const string_t &path, bool create = false, bool nothrow = false);
 	virtual bool IsValid() const;
 	virtual void EnumAllFiles(std::set<string_t> &files, const string_t &mask);
+	virtual void EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask);
 
 	static SafePtr<OSFileSystem> Create(const string_t &rootDirectory, const string_t &nodeName = TEXT(""));
 };
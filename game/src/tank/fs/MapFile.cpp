@@ -20,6 +20,50 @@ void MapFile::_skip_block(size_t size)
 
 //////////////////////////////////////////////////////////
 
+struct MapFile::ObjectDefinition::NameLess
+{
+	const std::vector<Property> &ps;
+	NameLess(const std::vector<Property> &ps_) : ps(ps_) {}
+	bool operator () (size_t a, size_t b) const { return ps[a].name < ps[b].name; }
+	bool operator () (size_t a, const char *b) const { return strcmp(ps[a].name.c_str(), b) < 0; }
+};
+
+void MapFile::ObjectDefinition::Compile()
+{
+	_intCount = _floatCount = _stringCount = 0;
+	for( size_t i = 0; i < _propertyset.size(); ++i )
+	{
+		switch( _propertyset[i].type )
+		{
+		case DATATYPE_INT:    _propertyset[i].slot = _intCount++;    break;
+		case DATATYPE_FLOAT:  _propertyset[i].slot = _floatCount++;  break;
+		case DATATYPE_STRING: _propertyset[i].slot = _stringCount++; break;
+		default:
+			throw std::runtime_error("invalid file");
+		}
+	}
+
+	_sorted.resize(_propertyset.size());
+	for( size_t i = 0; i < _sorted.size(); ++i )
+	{
+		_sorted[i] = i;
+	}
+	std::sort(_sorted.begin(), _sorted.end(), NameLess(_propertyset));
+}
+
+const MapFile::ObjectDefinition::Property* MapFile::ObjectDefinition::Find(const char *name) const
+{
+	std::vector<size_t>::const_iterator it =
+		std::lower_bound(_sorted.begin(), _sorted.end(), name, NameLess(_propertyset));
+	if( _sorted.end() != it && _propertyset[*it].name == name )
+	{
+		return &_propertyset[*it];
+	}
+	return NULL;
+}
+
+//////////////////////////////////////////////////////////
+
 MapFile::MapFile(const SafePtr<FS::Stream> &file, bool write)
   : _file(file)
   , _modeWrite(write)
@@ -268,39 +312,56 @@ void MapFile::setMapAttribute(const string_t &name, const string_t &value)
 
 
 
-bool MapFile::getObjectAttribute(const string_t &name, int &value) const
+const MapFile::ObjectDefinition::Property* MapFile::FindObjectProperty(const char *name, enumDataTypes type) const
 {
 	assert(!_modeWrite);
-	std::map<string_t, int>::const_iterator it;
-	it = _obj_attrs.attrs_int.find(name);
-	if( _obj_attrs.attrs_int.end() == it )
+	assert(_obj_type < _managed_classes.size());
+	const ObjectDefinition::Property *p = _managed_classes[_obj_type].Find(name);
+	return p && p->type == type ? p : NULL;
+}
+
+bool MapFile::getObjectAttribute(const char *name, int &value) const
+{
+	const ObjectDefinition::Property *p = FindObjectProperty(name, DATATYPE_INT);
+	if( !p )
 		return false;
-	value = it->second;
+	value = _obj_ints[p->slot];
 	return true;
 }
 
-bool MapFile::getObjectAttribute(const string_t &name, float &value) const
+bool MapFile::getObjectAttribute(const char *name, float &value) const
 {
-	assert(!_modeWrite);
-	std::map<string_t, float>::const_iterator it;
-	it = _obj_attrs.attrs_float.find(name);
-	if( _obj_attrs.attrs_float.end() == it )
+	const ObjectDefinition::Property *p = FindObjectProperty(name, DATATYPE_FLOAT);
+	if( !p )
 		return false;
-	value = it->second;
+	value = _obj_floats[p->slot];
 	return true;
 }
 
-bool MapFile::getObjectAttribute(const string_t &name, string_t &value) const
+bool MapFile::getObjectAttribute(const char *name, string_t &value) const
 {
-	assert(!_modeWrite);
-	std::map<string_t, string_t>::const_iterator it;
-	it = _obj_attrs.attrs_str.find(name);
-	if( _obj_attrs.attrs_str.end() == it )
+	const ObjectDefinition::Property *p = FindObjectProperty(name, DATATYPE_STRING);
+	if( !p )
 		return false;
-	value = it->second;
+	value = _obj_strings[p->slot];
 	return true;
 }
 
+bool MapFile::getObjectAttribute(const string_t &name, int &value) const
+{
+	return getObjectAttribute(name.c_str(), value);
+}
+
+bool MapFile::getObjectAttribute(const string_t &name, float &value) const
+{
+	return getObjectAttribute(name.c_str(), value);
+}
+
+bool MapFile::getObjectAttribute(const string_t &name, string_t &value) const
+{
+	return getObjectAttribute(name.c_str(), value);
+}
+
 void MapFile::setObjectAttribute(const string_t &name, int value)
 {
 	if( _isNewClass )
@@ -477,33 +538,63 @@ bool MapFile::NextObject()
 					ReadInt(reinterpret_cast<int&>(od._propertyset[i].type));
 					ReadString(od._propertyset[i].name);
 				}
+				od.Compile();
 				break;
 			}
 
 			case CHUNK_OBJECT:
 			{
-				_obj_attrs.clear();
+				// the whole object is read at once and decoded from memory
+				_chunk.resize(ch.chunkSize);
+				if( ch.chunkSize )
+					_file->Read(&_chunk[0], ch.chunkSize);
+				const char *pos = _chunk.empty() ? NULL : &_chunk[0];
+				const char *end = pos + _chunk.size();
 
-				ReadInt(reinterpret_cast<int&>(_obj_type));
+				int type;
+				if( end - pos < (int) sizeof(int) )
+					throw std::runtime_error("invalid file");
+				memcpy(&type, pos, sizeof(int));
+				pos += sizeof(int);
+				_obj_type = type;
 				if( _obj_type >= _managed_classes.size() )
 					throw std::runtime_error("invalid class");
 
-				const std::vector<ObjectDefinition::Property> &ps =
-					_managed_classes[_obj_type]._propertyset;
+				const ObjectDefinition &od = _managed_classes[_obj_type];
+				_obj_ints.resize(od._intCount);
+				_obj_floats.resize(od._floatCount);
+				_obj_strings.resize(od._stringCount);
 
-				for( size_t i = 0; i < ps.size(); i++ )
+				for( size_t i = 0; i < od._propertyset.size(); i++ )
 				{
-					switch( ps[i].type )
+					const ObjectDefinition::Property &p = od._propertyset[i];
+					switch( p.type )
 					{
 					case DATATYPE_INT:
-						ReadInt(_obj_attrs.attrs_int[ps[i].name]);
+						if( end - pos < (int) sizeof(int) )
+							throw std::runtime_error("invalid file");
+						memcpy(&_obj_ints[p.slot], pos, sizeof(int));
+						pos += sizeof(int);
 						break;
 					case DATATYPE_FLOAT:
-						ReadFloat(_obj_attrs.attrs_float[ps[i].name]);
+						if( end - pos < (int) sizeof(float) )
+							throw std::runtime_error("invalid file");
+						memcpy(&_obj_floats[p.slot], pos, sizeof(float));
+						pos += sizeof(float);
 						break;
 					case DATATYPE_STRING:
-						ReadString(_obj_attrs.attrs_str[ps[i].name]);
+					{
+						unsigned short len;
+						if( end - pos < (int) sizeof(unsigned short) )
+							throw std::runtime_error("invalid file");
+						memcpy(&len, pos, sizeof(unsigned short));
+						pos += sizeof(unsigned short);
+						if( end - pos < (int) len )
+							throw std::runtime_error("invalid file");
+						_obj_strings[p.slot].assign(pos, len);
+						pos += len;
 						break;
+					}
 					default:
 						throw std::runtime_error("invalid file");
 					}
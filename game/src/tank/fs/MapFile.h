@@ -111,11 +111,13 @@ class MapFile
 		public:
 			enumDataTypes type;
 			string_t   name;
-			Property() {}
+			size_t     slot; // index in the value array of the same type; set by Compile()
+			Property() : slot(0) {}
 			Property(const Property &x)
 			{
 				name = x.name;
 				type = x.type;
+				slot = x.slot;
 			}
 			size_t CalcSize() const
 			{
@@ -126,13 +128,27 @@ class MapFile
 		string_t           _className;
 		std::vector<Property> _propertyset;
 
-		ObjectDefinition() {}
+		// loading only: layout of the object values and a name index
+		std::vector<size_t> _sorted; // indices in _propertyset ordered by name
+		size_t _intCount;
+		size_t _floatCount;
+		size_t _stringCount;
+
+		ObjectDefinition() : _intCount(0), _floatCount(0), _stringCount(0) {}
 		ObjectDefinition(const ObjectDefinition &x)
 		{
 			_className   = x._className;
 			_propertyset = x._propertyset;
+			_sorted      = x._sorted;
+			_intCount    = x._intCount;
+			_floatCount  = x._floatCount;
+			_stringCount = x._stringCount;
 		}
 
+		void Compile();
+		const Property* Find(const char *name) const; // binary search
+		struct NameLess;
+
 		size_t CalcSize() const
 		{
 			size_t size = sizeof(unsigned short) + _className.size();
@@ -155,7 +171,11 @@ private:
 	std::vector<ObjectDefinition> _managed_classes;
 	std::map<string_t, size_t> _name_to_index; // map classname to index in _managed_classes
 
-	AttributeSet _obj_attrs;
+	// values of the current object laid out according to ObjectDefinition::Compile
+	std::vector<int>      _obj_ints;
+	std::vector<float>    _obj_floats;
+	std::vector<string_t> _obj_strings;
+	std::vector<char>     _chunk; // raw object data, reused between objects
 	size_t  _obj_type; // index in _managed_classes
 
 	std::map<string_t, AttributeSet> _defaults;
@@ -174,6 +194,8 @@ private:
 	void ReadFloat(float &value);
 	void ReadString(string_t &value);
 
+	const ObjectDefinition::Property* FindObjectProperty(const char *name, enumDataTypes type) const;
+
 public:
 	MapFile(const SafePtr<FS::Stream> &file, bool write);
 	~MapFile();
@@ -183,6 +205,8 @@ public:
 
 	bool NextObject();
 	const string_t& GetCurrentClassName() const;
+	size_t GetCurrentClassIndex() const { return _obj_type; }
+	const string_t& GetClassName(size_t index) const { return _managed_classes[index]._className; }
 
 
 	void BeginObject(const char *classname);
@@ -198,6 +222,9 @@ public:
 	void setMapAttribute(const string_t &name, const string_t &value);
 
 
+	bool getObjectAttribute(const char *name, int &value) const;
+	bool getObjectAttribute(const char *name, float &value) const;
+	bool getObjectAttribute(const char *name, string_t &value) const;
 	bool getObjectAttribute(const string_t &name, int &value) const;
 	bool getObjectAttribute(const string_t &name, float &value) const;
 	bool getObjectAttribute(const string_t &name, string_t &value) const;
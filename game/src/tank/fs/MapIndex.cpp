@@ -0,0 +1,298 @@
+// MapIndex.cpp
+
+#include "stdafx.h"
+#include "MapIndex.h"
+#include "MapFile.h"
+
+#include "core/debug.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const char INDEX_SIGNATURE[] = "mapindex 1";
+
+static string_t Escape(const string_t &str)
+{
+	string_t result;
+	result.reserve(str.length());
+	for( string_t::const_iterator it = str.begin(); it != str.end(); ++it )
+	{
+		switch( *it )
+		{
+		case '\\': result += "\\\\"; break;
+		case '\t': result += "\\t";  break;
+		case '\n': result += "\\n";  break;
+		case '\r':                   break;
+		default:   result += *it;
+		}
+	}
+	return result;
+}
+
+static string_t Unescape(const string_t &str)
+{
+	string_t result;
+	result.reserve(str.length());
+	for( string_t::const_iterator it = str.begin(); it != str.end(); ++it )
+	{
+		if( '\\' == *it && str.end() != it + 1 )
+		{
+			switch( *++it )
+			{
+			case 't': result += '\t'; break;
+			case 'n': result += '\n'; break;
+			default:  result += *it;
+			}
+		}
+		else
+		{
+			result += *it;
+		}
+	}
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MapInfo::MapInfo()
+  : size(0)
+  , stamp(0)
+  , valid(false)
+  , width(0)
+  , height(0)
+{
+}
+
+void MapInfo::ReadFrom(const MapFile &file)
+{
+	width = height = 0;
+	file.getMapAttribute("width", width);
+	file.getMapAttribute("height", height);
+
+	theme.clear();
+	author.clear();
+	email.clear();
+	url.clear();
+	desc.clear();
+	file.getMapAttribute("theme", theme);
+	file.getMapAttribute("author", author);
+	file.getMapAttribute("e-mail", email);
+	file.getMapAttribute("link-url", url);
+	file.getMapAttribute("desc", desc);
+
+	valid = true;
+}
+
+string_t MapInfo::Format() const
+{
+	struct Quote
+	{
+		static void Add(std::ostringstream &s, const char *key, const string_t &value)
+		{
+			if( value.empty() )
+				return;
+			s << key << "=\"";
+			for( string_t::const_iterator it = value.begin(); it != value.end(); ++it )
+			{
+				switch( *it )
+				{
+				case '\\': s << "\\\\"; break;
+				case '\t': s << "\\t";  break;
+				case '\n': s << "\\n";  break;
+				case '"':  s << "\\\""; break;
+				case '\r':              break;
+				default:   s << *it;
+				}
+			}
+			s << "\" ";
+		}
+	};
+
+	std::ostringstream s;
+	Quote::Add(s, "author", author);
+	Quote::Add(s, "email", email);
+	Quote::Add(s, "url", url);
+	Quote::Add(s, "desc", desc);
+	Quote::Add(s, "theme", theme);
+	if( width && height )
+	{
+		s << "mapsize=\"" << width << "x" << height << "\" ";
+	}
+	return s.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MapIndex::MapIndex(const SafePtr<FS::FileSystem> &dir, const SafePtr<FS::FileSystem> &store, const string_t &indexName)
+  : _dir(dir)
+  , _store(store)
+  , _indexName(indexName)
+  , _dirty(false)
+{
+	try
+	{
+		Load();
+	}
+	catch( const std::exception &e )
+	{
+		TRACE("map index will be rebuilt - %s", e.what());
+		_maps.clear();
+	}
+}
+
+MapIndex::~MapIndex()
+{
+	try
+	{
+		Save();
+	}
+	catch( const std::exception &e )
+	{
+		TRACE("could not save map index - %s", e.what());
+	}
+}
+
+void MapIndex::Load()
+{
+	std::set<string_t> files;
+	_store->EnumAllFiles(files, _indexName);
+	if( files.empty() )
+	{
+		return; // first run
+	}
+
+	SafePtr<FS::MemMap> data = _store->Open(_indexName)->QueryMap();
+	std::istringstream in(string_t(data->GetData(), data->GetSize()));
+
+	string_t line;
+	if( !std::getline(in, line) || INDEX_SIGNATURE != line )
+	{
+		throw std::runtime_error("unknown index format");
+	}
+
+	while( std::getline(in, line) )
+	{
+		std::vector<string_t> fields;
+		for( string_t::size_type pos = 0;; )
+		{
+			string_t::size_type tab = line.find('\t', pos);
+			fields.push_back(Unescape(line.substr(pos, string_t::npos == tab ? tab : tab - pos)));
+			if( string_t::npos == tab )
+				break;
+			pos = tab + 1;
+		}
+		if( fields.size() != 11 )
+		{
+			throw std::runtime_error("corrupted index");
+		}
+
+		MapInfo &info = _maps[fields[0]];
+		std::istringstream(fields[1]) >> info.size;
+		std::istringstream(fields[2]) >> info.stamp;
+		info.valid = "1" == fields[3];
+		std::istringstream(fields[4]) >> info.width;
+		std::istringstream(fields[5]) >> info.height;
+		info.theme = fields[6];
+		info.author = fields[7];
+		info.email = fields[8];
+		info.url = fields[9];
+		info.desc = fields[10];
+	}
+}
+
+void MapIndex::Save()
+{
+	if( !_dirty )
+	{
+		return;
+	}
+
+	std::ostringstream out;
+	out << INDEX_SIGNATURE << "\n";
+	for( InfoMap::const_iterator it = _maps.begin(); it != _maps.end(); ++it )
+	{
+		if( IsStale(it->first) )
+		{
+			continue; // will be parsed next time
+		}
+		const MapInfo &info = it->second;
+		out << Escape(it->first) << '\t' << info.size << '\t' << info.stamp << '\t'
+		    << (info.valid ? 1 : 0) << '\t' << info.width << '\t' << info.height << '\t'
+		    << Escape(info.theme) << '\t' << Escape(info.author) << '\t' << Escape(info.email) << '\t'
+		    << Escape(info.url) << '\t' << Escape(info.desc) << '\n';
+	}
+
+	string_t buf = out.str();
+	_store->Open(_indexName, FS::ModeWrite)->QueryStream()->Write(buf.data(), buf.size());
+	_dirty = false;
+}
+
+void MapIndex::Refresh()
+{
+	std::map<string_t, FS::FileInfo> files;
+	_dir->EnumFileInfo(files, "*.map");
+
+	std::map<string_t, FS::FileInfo> current;
+	for( std::map<string_t, FS::FileInfo>::const_iterator it = files.begin(); it != files.end(); ++it )
+	{
+		current[it->first.substr(0, it->first.length() - 4)] = it->second; // cut out the file extension
+	}
+
+	// forget removed maps
+	for( InfoMap::iterator it = _maps.begin(); it != _maps.end(); )
+	{
+		if( current.count(it->first) )
+		{
+			++it;
+		}
+		else
+		{
+			_stale.erase(it->first);
+			_maps.erase(it++);
+			_dirty = true;
+		}
+	}
+
+	// new maps get an empty entry until they are parsed
+	for( std::map<string_t, FS::FileInfo>::const_iterator it = current.begin(); it != current.end(); ++it )
+	{
+		const MapInfo &info = _maps[it->first];
+		if( info.size != it->second.size || info.stamp != it->second.stamp || 0 == info.stamp )
+		{
+			_stale[it->first] = it->second;
+		}
+	}
+}
+
+bool MapIndex::Update(size_t maxCount, std::vector<string_t> *updated)
+{
+	for( ; maxCount && !_stale.empty(); --maxCount )
+	{
+		string_t name = _stale.begin()->first;
+		FS::FileInfo fi = _stale.begin()->second;
+		_stale.erase(_stale.begin());
+
+		MapInfo &info = _maps[name];
+		try
+		{
+			MapFile file(_dir->Open(name + ".map")->QueryStream(), false);
+			info.ReadFrom(file);
+		}
+		catch( const std::exception &e )
+		{
+			TRACE("could not get attributes of map '%s' - %s", name.c_str(), e.what());
+			info = MapInfo();
+		}
+		info.size = fi.size;
+		info.stamp = fi.stamp;
+		_dirty = true;
+
+		if( updated )
+		{
+			updated->push_back(name);
+		}
+	}
+	return !_stale.empty();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,70 @@
+// MapIndex.h
+
+#pragma once
+
+#include "FileSystem.h"
+
+class MapFile;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct MapInfo
+{
+	unsigned long long size;   // file size and stamp the attributes were read from
+	unsigned long long stamp;
+	bool      valid;           // false if the map could not be parsed
+	int       width;
+	int       height;
+	string_t  theme;
+	string_t  author;
+	string_t  email;
+	string_t  url;
+	string_t  desc;
+
+	MapInfo();
+
+	// shared with tools/mapinfo
+	void ReadFrom(const MapFile &file);
+	string_t Format() const; // author="..." email="..." ... mapsize="WxH"
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// persistent cache of map attributes. the directory listing is compared with
+// the index by size and time, so only new or modified maps have to be parsed.
+// the index is kept in a separate, writable file system since the maps may
+// come from a read-only archive.
+
+class MapIndex
+{
+public:
+	typedef std::map<string_t, MapInfo> InfoMap; // the key is the map name without extension
+
+	MapIndex(const SafePtr<FS::FileSystem> &dir, const SafePtr<FS::FileSystem> &store, const string_t &indexName);
+	~MapIndex(); // saves changes
+
+	// lists the directory without opening any map; new and modified maps become stale
+	void Refresh();
+
+	// parses at most maxCount stale maps; returns false when the index is up to date
+	bool Update(size_t maxCount, std::vector<string_t> *updated = NULL);
+
+	const InfoMap& GetMaps() const { return _maps; }
+	bool IsStale(const string_t &name) const { return _stale.count(name) > 0; }
+
+	void Save();
+
+private:
+	typedef std::map<string_t, FS::FileInfo> StaleMap;
+
+	SafePtr<FS::FileSystem> _dir;
+	SafePtr<FS::FileSystem> _store;
+	string_t _indexName;
+	InfoMap  _maps;
+	StaleMap _stale;
+	bool _dirty;
+
+	void Load();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
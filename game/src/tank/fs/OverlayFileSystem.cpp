@@ -0,0 +1,135 @@
+// OverlayFileSystem.cpp
+
+#include "stdafx.h"
+#include "OverlayFileSystem.h"
+
+namespace FS {
+
+///////////////////////////////////////////////////////////////////////////////
+
+SafePtr<OverlayFileSystem> OverlayFileSystem::Create(const SafePtr<FileSystem> &upper,
+                                                     const SafePtr<FileSystem> &lower,
+                                                     const string_t &nodeName)
+{
+	assert(lower);
+	return new OverlayFileSystem(upper, lower, nodeName);
+}
+
+OverlayFileSystem::OverlayFileSystem(const SafePtr<FileSystem> &upper, const SafePtr<FileSystem> &lower, const string_t &nodeName)
+  : FileSystem(nodeName)
+  , _upper(upper)
+  , _lower(lower)
+{
+}
+
+OverlayFileSystem::~OverlayFileSystem()
+{
+}
+
+SafePtr<File> OverlayFileSystem::RawOpen(const string_t &fileName, FileMode mode)
+{
+	assert(string_t::npos == fileName.find(DELIMITER));
+
+	if( mode & ModeWrite )
+	{
+		if( !_upper )
+		{
+			throw std::runtime_error("overlay has no writable layer");
+		}
+		return _upper->Open(fileName, mode);
+	}
+
+	if( _upper )
+	{
+		try
+		{
+			return _upper->Open(fileName, mode);
+		}
+		catch( const std::exception & )
+		{
+			// not there; try the lower layer
+		}
+	}
+	return _lower->Open(fileName, mode);
+}
+
+SafePtr<FileSystem> OverlayFileSystem::GetFileSystem(const string_t &path, bool create, bool nothrow)
+{
+	if( SafePtr<FileSystem> tmp = FileSystem::GetFileSystem(path, create, true) )
+	{
+		return tmp;
+	}
+
+	assert(!path.empty());
+
+	// skip delimiters at the beginning
+	string_t::size_type offset = 0;
+	while( offset < path.length() && path[offset] == DELIMITER )
+		++offset;
+	assert(path.length() > offset);
+
+	string_t::size_type p = path.find(DELIMITER, offset);
+	string_t dirName = path.substr(offset, string_t::npos != p ? p - offset : p);
+
+	// only the upper layer can create directories
+	SafePtr<FileSystem> upper = _upper ? _upper->GetFileSystem(dirName, create, true) : NULL;
+	SafePtr<FileSystem> lower = _lower->GetFileSystem(dirName, false, true);
+
+	SafePtr<FileSystem> child;
+	if( upper && lower )
+	{
+		child = new OverlayFileSystem(upper, lower, dirName);
+		child->MountTo(this);
+	}
+	else if( upper || lower )
+	{
+		child = upper ? upper : lower;
+	}
+	else
+	{
+		if( nothrow )
+			return NULL;
+		else
+			throw std::runtime_error(create ? "could not create directory" : "directory not found");
+	}
+
+	if( string_t::npos != p )
+		return child->GetFileSystem(path.substr(p), create, nothrow); // process the rest of the path
+	return child; // last path node was processed
+}
+
+bool OverlayFileSystem::IsValid() const
+{
+	return _lower->IsValid() && (!_upper || _upper->IsValid());
+}
+
+void OverlayFileSystem::EnumAllFiles(std::set<string_t> &files, const string_t &mask)
+{
+	_lower->EnumAllFiles(files, mask);
+	if( _upper )
+	{
+		std::set<string_t> layer;
+		_upper->EnumAllFiles(layer, mask);
+		files.insert(layer.begin(), layer.end());
+	}
+}
+
+void OverlayFileSystem::EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask)
+{
+	_lower->EnumFileInfo(files, mask);
+	if( _upper )
+	{
+		// files in the upper layer hide the ones in the archive
+		std::map<string_t, FileInfo> layer;
+		_upper->EnumFileInfo(layer, mask);
+		for( std::map<string_t, FileInfo>::const_iterator it = layer.begin(); it != layer.end(); ++it )
+		{
+			files[it->first] = it->second;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // end of namespace FS
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,39 @@
+// OverlayFileSystem.h
+
+#pragma once
+
+#include "FileSystem.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace FS {
+
+// shows two file systems as one. files are read from the upper one if they
+// exist there and from the lower one otherwise; writes always go to the
+// upper one. used to put a writable directory over a read-only archive.
+class OverlayFileSystem : public FileSystem
+{
+	SafePtr<FileSystem> _upper; // may be NULL if there is nothing to write to
+	SafePtr<FileSystem> _lower;
+
+	OverlayFileSystem(const SafePtr<FileSystem> &upper, const SafePtr<FileSystem> &lower, const string_t &nodeName);
+
+protected:
+	virtual ~OverlayFileSystem();
+	virtual SafePtr<File> RawOpen(const string_t &fileName, FileMode mode);
+
+public:
+	virtual SafePtr<FileSystem> GetFileSystem(const string_t &path, bool create = false, bool nothrow = false);
+	virtual bool IsValid() const;
+	virtual void EnumAllFiles(std::set<string_t> &files, const string_t &mask);
+	virtual void EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask);
+
+	static SafePtr<OverlayFileSystem> Create(const SafePtr<FileSystem> &upper,
+	                                         const SafePtr<FileSystem> &lower,
+	                                         const string_t &nodeName = TEXT(""));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+} // end of namespace FS
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,418 @@
+// PackFileSystem.cpp
+
+#include "stdafx.h"
+#include "PackFileSystem.h"
+
+namespace FS {
+
+///////////////////////////////////////////////////////////////////////////////
+
+static string_t ToLower(const string_t &str)
+{
+	string_t result(str);
+	for( string_t::iterator it = result.begin(); result.end() != it; ++it )
+	{
+		if( *it >= TEXT('A') && *it <= TEXT('Z') )
+			*it += TEXT('a') - TEXT('A');
+	}
+	return result;
+}
+
+static bool EqualNoCase(const char *a, const char *b)
+{
+	for( ; *a && *b; ++a, ++b )
+	{
+		if( tolower((unsigned char) *a) != tolower((unsigned char) *b) )
+			return false;
+	}
+	return *a == *b;
+}
+
+static bool StartsWithNoCase(const char *str, const string_t &prefix)
+{
+	for( string_t::size_type i = 0; i < prefix.length(); ++i )
+	{
+		if( !str[i] || tolower((unsigned char) str[i]) != tolower((unsigned char) prefix[i]) )
+			return false;
+	}
+	return true;
+}
+
+// case insensitive match against a mask with '*' and '?' wildcards
+static bool MatchMask(const char *name, const char *mask)
+{
+	const char *star = NULL;
+	const char *retry = NULL;
+	while( *name )
+	{
+		if( '*' == *mask )
+		{
+			star = ++mask;
+			retry = name;
+		}
+		else if( '?' == *mask || tolower((unsigned char) *mask) == tolower((unsigned char) *name) )
+		{
+			++mask;
+			++name;
+		}
+		else if( star )
+		{
+			mask = star;
+			name = ++retry;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	while( '*' == *mask )
+		++mask;
+	return !*mask;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PackFileSystem::Archive::Archive(const SafePtr<MemMap> &data)
+  : _data(data)
+  , _header(NULL)
+  , _buckets(NULL)
+  , _entries(NULL)
+  , _names(NULL)
+{
+	const char *base = _data->GetData();
+	unsigned long size = _data->GetSize();
+
+	if( size < sizeof(PackHeader) )
+	{
+		throw std::runtime_error("archive is too small");
+	}
+
+	_header = (const PackHeader *) base;
+	if( memcmp(_header->signature, PACK_SIGNATURE, 4) || PACK_VERSION != _header->version )
+	{
+		throw std::runtime_error("unknown archive format");
+	}
+	if( 0 == _header->bucketCount || (_header->bucketCount & (_header->bucketCount - 1)) )
+	{
+		throw std::runtime_error("corrupted archive directory");
+	}
+
+	unsigned long long dirSize = sizeof(PackHeader)
+		+ (unsigned long long) _header->bucketCount * sizeof(unsigned int)
+		+ (unsigned long long) _header->entryCount * sizeof(PackEntry)
+		+ _header->namesSize;
+	if( dirSize > size || 0 == _header->namesSize )
+	{
+		throw std::runtime_error("corrupted archive directory");
+	}
+
+	_buckets = (const unsigned int *) (_header + 1);
+	_entries = (const PackEntry *) (_buckets + _header->bucketCount);
+	_names = (const char *) (_entries + _header->entryCount);
+
+	if( _names[_header->namesSize - 1] )
+	{
+		throw std::runtime_error("corrupted archive directory");
+	}
+
+	for( unsigned int i = 0; i < _header->bucketCount; ++i )
+	{
+		if( PACK_NO_ENTRY != _buckets[i] && _buckets[i] >= _header->entryCount )
+		{
+			throw std::runtime_error("corrupted archive directory");
+		}
+	}
+
+	for( unsigned int i = 0; i < _header->entryCount; ++i )
+	{
+		const PackEntry &e = _entries[i];
+		if( e.nameOffset >= _header->namesSize
+			|| (unsigned long long) e.dataOffset + e.storedSize > size
+			|| (PACK_NO_ENTRY != e.next && e.next >= _header->entryCount)
+			|| (0 == (e.flags & PACK_COMPRESSED) && e.storedSize != e.originalSize) )
+		{
+			throw std::runtime_error("corrupted archive directory");
+		}
+
+		// register every directory on the way to the file
+		string_t path = ToLower(GetName(e));
+		for( string_t::size_type p = path.find(DELIMITER); string_t::npos != p; p = path.find(DELIMITER, p + 1) )
+		{
+			_dirs.insert(path.substr(0, p + 1));
+		}
+	}
+}
+
+const PackEntry* PackFileSystem::Archive::Find(const string_t &path) const
+{
+	unsigned int hash = PackHashPath(path.c_str());
+	unsigned int index = _buckets[hash & (_header->bucketCount - 1)];
+	unsigned int guard = _header->entryCount; // protects against looped chains
+	while( PACK_NO_ENTRY != index && guard-- )
+	{
+		const PackEntry &e = _entries[index];
+		if( e.hash == hash && EqualNoCase(GetName(e), path.c_str()) )
+		{
+			return &e;
+		}
+		index = e.next;
+	}
+	return NULL;
+}
+
+bool PackFileSystem::Archive::IsDirectory(const string_t &path) const
+{
+	return _dirs.count(ToLower(path)) > 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PackFileSystem::PackFile::PackFile(const SafePtr<Archive> &archive, const PackEntry *entry)
+  : _archive(archive)
+  , _entry(entry)
+  , _mapped(false)
+  , _streamed(false)
+{
+}
+
+PackFileSystem::PackFile::~PackFile()
+{
+}
+
+char* PackFileSystem::PackFile::GetData()
+{
+	if( 0 == (_entry->flags & PACK_COMPRESSED) || 0 == _entry->originalSize )
+	{
+		return _archive->GetData(*_entry); // zero copy
+	}
+
+	if( _unpacked.empty() )
+	{
+		std::vector<char> buf(_entry->originalSize);
+		uLongf size = _entry->originalSize;
+		int result = uncompress((Bytef *) &buf[0], &size,
+			(const Bytef *) _archive->GetData(*_entry), _entry->storedSize);
+		if( Z_OK != result || size != _entry->originalSize )
+		{
+			throw std::runtime_error("failed to unpack archive entry");
+		}
+		_unpacked.swap(buf);
+	}
+	return &_unpacked[0];
+}
+
+SafePtr<MemMap> PackFileSystem::PackFile::QueryMap()
+{
+	assert(!_mapped && !_streamed);
+	SafePtr<MemMap> result(new PackMemMap(this, GetData(), _entry->originalSize));
+	_mapped = true;
+	return result;
+}
+
+SafePtr<Stream> PackFileSystem::PackFile::QueryStream()
+{
+	assert(!_mapped && !_streamed);
+	SafePtr<Stream> result(new PackStream(this, GetData(), _entry->originalSize));
+	_streamed = true;
+	return result;
+}
+
+void PackFileSystem::PackFile::Unmap()
+{
+	assert(_mapped && !_streamed);
+	_mapped = false;
+}
+
+void PackFileSystem::PackFile::Unstream()
+{
+	assert(_streamed && !_mapped);
+	_streamed = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PackFileSystem::PackFile::PackMemMap::PackMemMap(const SafePtr<File> &parent, char *data, unsigned long size)
+  : MemMap(parent)
+  , _data(data)
+  , _size(size)
+{
+}
+
+char* PackFileSystem::PackFile::PackMemMap::GetData()
+{
+	return _data;
+}
+
+unsigned long PackFileSystem::PackFile::PackMemMap::GetSize() const
+{
+	return _size;
+}
+
+void PackFileSystem::PackFile::PackMemMap::SetSize(unsigned long size)
+{
+	throw std::runtime_error("archive is read-only");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PackFileSystem::PackFile::PackStream::PackStream(const SafePtr<File> &parent, const char *data, unsigned long size)
+  : Stream(parent)
+  , _data(data)
+  , _size(size)
+  , _pos(0)
+{
+}
+
+bool PackFileSystem::PackFile::PackStream::IsEof()
+{
+	return _pos >= _size;
+}
+
+unsigned long PackFileSystem::PackFile::PackStream::Read(void *dst, unsigned long blockSize, unsigned long numBlocks)
+{
+	unsigned long avail = _pos < _size ? _size - _pos : 0;
+	unsigned long bytesRead = (unsigned long) std::min((unsigned long long) avail, (unsigned long long) blockSize * numBlocks);
+	memcpy(dst, _data + _pos, bytesRead);
+	_pos += bytesRead;
+	if( bytesRead % blockSize )
+	{
+		throw std::runtime_error("unexpected end of file");
+	}
+	return bytesRead / blockSize;
+}
+
+void PackFileSystem::PackFile::PackStream::Write(const void *src, unsigned long byteCount)
+{
+	throw std::runtime_error("archive is read-only");
+}
+
+unsigned long long PackFileSystem::PackFile::PackStream::Seek(long long amount, unsigned int origin)
+{
+	long long target;
+	switch( origin )
+	{
+	case SEEK_SET: target = amount; break;
+	case SEEK_CUR: target = (long long) _pos + amount; break;
+	case SEEK_END: target = (long long) _size + amount; break;
+	default:
+		assert(false);
+		target = amount;
+	}
+	if( target < 0 || target > (long long) _size )
+	{
+		throw std::runtime_error("seek out of range");
+	}
+	_pos = (unsigned long) target;
+	return _pos;
+}
+
+unsigned long long PackFileSystem::PackFile::PackStream::GetSize()
+{
+	return _size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SafePtr<PackFileSystem> PackFileSystem::Create(const SafePtr<File> &archive, const string_t &nodeName)
+{
+	SafePtr<Archive> a(new Archive(archive->QueryMap()));
+	return new PackFileSystem(a, string_t(), nodeName);
+}
+
+PackFileSystem::PackFileSystem(const SafePtr<Archive> &archive, const string_t &prefix, const string_t &nodeName)
+  : FileSystem(nodeName)
+  , _archive(archive)
+  , _prefix(prefix)
+{
+}
+
+PackFileSystem::~PackFileSystem()
+{
+}
+
+SafePtr<File> PackFileSystem::RawOpen(const string_t &fileName, FileMode mode)
+{
+	if( mode & ModeWrite )
+	{
+		throw std::runtime_error("archive is read-only");
+	}
+
+	const PackEntry *entry = _archive->Find(_prefix + fileName);
+	if( !entry )
+	{
+		throw std::runtime_error("file not found in archive");
+	}
+	return new PackFile(_archive, entry);
+}
+
+SafePtr<FileSystem> PackFileSystem::GetFileSystem(const string_t &path, bool create, bool nothrow)
+{
+	if( SafePtr<FileSystem> tmp = FileSystem::GetFileSystem(path, create, true) )
+	{
+		return tmp;
+	}
+
+	assert(!path.empty());
+
+	// skip delimiters at the beginning
+	string_t::size_type offset = 0;
+	while( offset < path.length() && path[offset] == DELIMITER )
+		++offset;
+	assert(path.length() > offset);
+
+	string_t::size_type p = path.find(DELIMITER, offset);
+	string_t dirName = path.substr(offset, string_t::npos != p ? p - offset : p);
+	string_t dirPath = _prefix + dirName + DELIMITER;
+
+	if( !_archive->IsDirectory(dirPath) )
+	{
+		if( nothrow )
+			return NULL;
+		else
+			throw std::runtime_error(create ? "archive is read-only" : "directory not found in archive");
+	}
+
+	SafePtr<FileSystem> child(new PackFileSystem(_archive, dirPath, dirName));
+	child->MountTo(this);
+	if( string_t::npos != p )
+		return child->GetFileSystem(path.substr(p), create, nothrow); // process the rest of the path
+	return child; // last path node was processed
+}
+
+void PackFileSystem::EnumAllFiles(std::set<string_t> &files, const string_t &mask)
+{
+	std::map<string_t, FileInfo> info;
+	EnumFileInfo(info, mask);
+	files.clear();
+	for( std::map<string_t, FileInfo>::const_iterator it = info.begin(); it != info.end(); ++it )
+	{
+		files.insert(files.end(), it->first);
+	}
+}
+
+void PackFileSystem::EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask)
+{
+	files.clear();
+	for( unsigned int i = 0; i < _archive->GetEntryCount(); ++i )
+	{
+		const PackEntry &entry = _archive->GetEntry(i);
+		const char *name = _archive->GetName(entry);
+		if( !StartsWithNoCase(name, _prefix) )
+		{
+			continue;
+		}
+		name += _prefix.length();
+		if( NULL == strchr(name, DELIMITER) && MatchMask(name, mask.c_str()) )
+		{
+			// archive entries have no time; their location changes whenever the archive is rebuilt
+			FileInfo &info = files[name];
+			info.size = entry.originalSize;
+			info.stamp = ((unsigned long long) entry.dataOffset << 32) | entry.hash;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // end of namespace FS
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,114 @@
+// PackFileSystem.h
+
+#pragma once
+
+#include "FileSystem.h"
+#include "PackFormat.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace FS {
+
+// read-only file system over a single archive built by tools/mkpack.
+// the archive is mapped once; uncompressed entries are served as views into
+// that mapping, compressed ones are inflated on first access.
+class PackFileSystem : public FileSystem
+{
+	class Archive : public RefCounted
+	{
+	public:
+		Archive(const SafePtr<MemMap> &data);
+
+		// path is relative to the archive root and uses DELIMITER
+		const PackEntry* Find(const string_t &path) const;
+		bool IsDirectory(const string_t &path) const;
+
+		unsigned int GetEntryCount() const { return _header->entryCount; }
+		const PackEntry& GetEntry(unsigned int index) const { return _entries[index]; }
+		const char* GetName(const PackEntry &entry) const { return _names + entry.nameOffset; }
+		char* GetData(const PackEntry &entry) const { return _data->GetData() + entry.dataOffset; }
+
+	private:
+		SafePtr<MemMap> _data;
+		const PackHeader *_header;
+		const unsigned int *_buckets;
+		const PackEntry *_entries;
+		const char *_names;
+		std::set<string_t> _dirs; // lower case with trailing delimiter
+	};
+
+	class PackFile : public File
+	{
+	public:
+		PackFile(const SafePtr<Archive> &archive, const PackEntry *entry);
+		virtual ~PackFile();
+
+		// File
+		virtual SafePtr<MemMap> QueryMap();
+		virtual SafePtr<Stream> QueryStream();
+		virtual void Unmap();
+		virtual void Unstream();
+
+	private:
+		class PackMemMap : public MemMap
+		{
+		public:
+			PackMemMap(const SafePtr<File> &parent, char *data, unsigned long size);
+
+			virtual char* GetData();
+			virtual unsigned long GetSize() const;
+			virtual void SetSize(unsigned long size); // not supported
+
+		private:
+			char *_data;
+			unsigned long _size;
+		};
+
+		class PackStream : public Stream
+		{
+		public:
+			PackStream(const SafePtr<File> &parent, const char *data, unsigned long size);
+
+			virtual bool IsEof();
+			virtual unsigned long Read(void *dst, unsigned long blockSize, unsigned long numBlocks);
+			virtual void Write(const void *src, unsigned long byteCount); // not supported
+			virtual unsigned long long Seek(long long amount, unsigned int origin);
+			virtual unsigned long long GetSize();
+
+		private:
+			const char *_data;
+			unsigned long _size;
+			unsigned long _pos;
+		};
+
+		char* GetData(); // inflates compressed entries on first call
+
+		SafePtr<Archive> _archive;
+		const PackEntry *_entry;
+		std::vector<char> _unpacked;
+		bool _mapped;
+		bool _streamed;
+	};
+
+	SafePtr<Archive> _archive;
+	string_t _prefix; // path of this node inside the archive with trailing delimiter
+
+	// private constructor for internal use by GetFileSystem() and Create()
+	PackFileSystem(const SafePtr<Archive> &archive, const string_t &prefix, const string_t &nodeName);
+
+protected:
+	virtual ~PackFileSystem();
+	virtual SafePtr<File> RawOpen(const string_t &fileName, FileMode mode);
+
+public:
+	virtual SafePtr<FileSystem> GetFileSystem(const string_t &path, bool create = false, bool nothrow = false);
+	virtual void EnumAllFiles(std::set<string_t> &files, const string_t &mask);
+	virtual void EnumFileInfo(std::map<string_t, FileInfo> &files, const string_t &mask);
+
+	static SafePtr<PackFileSystem> Create(const SafePtr<File> &archive, const string_t &nodeName = TEXT(""));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+} // end of namespace FS
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,63 @@
+// PackFormat.h
+// on-disk layout of the game data archive; shared with tools/mkpack
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// [PackHeader]
+// [unsigned int buckets[bucketCount]]  - first entry of each hash chain
+// [PackEntry    entries[entryCount]]
+// [char         names[namesSize]]      - zero terminated paths relative to the archive root
+// [entry data]                         - each entry starts at a PACK_ALIGNMENT boundary
+//
+// paths use '/' as delimiter; the hash is computed over the lower case path,
+// so lookups are case insensitive like the windows file system.
+// all values are little endian.
+
+#define PACK_SIGNATURE    "TZPK"
+#define PACK_VERSION      1
+#define PACK_ALIGNMENT    4096
+#define PACK_NO_ENTRY     0xffffffff
+
+enum PackEntryFlags
+{
+	PACK_COMPRESSED = 0x01, // data is a zlib stream; storedSize is the compressed size
+};
+
+struct PackHeader
+{
+	char         signature[4];
+	unsigned int version;
+	unsigned int entryCount;
+	unsigned int bucketCount;  // power of two
+	unsigned int namesSize;
+};
+
+struct PackEntry
+{
+	unsigned int hash;
+	unsigned int next;         // next entry in the same bucket or PACK_NO_ENTRY
+	unsigned int nameOffset;   // offset in the name table
+	unsigned int flags;
+	unsigned int dataOffset;   // from the beginning of the archive
+	unsigned int storedSize;
+	unsigned int originalSize;
+};
+
+inline unsigned int PackHashPath(const char *path)
+{
+	// fnv-1a over the lower case path
+	unsigned int hash = 2166136261U;
+	for( ; *path; ++path )
+	{
+		unsigned char c = (unsigned char) *path;
+		if( c >= 'A' && c <= 'Z' )
+			c += 'a' - 'A';
+		hash = (hash ^ c) * 16777619U;
+	}
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -58,6 +58,37 @@ GC_Wood::~GC_Wood()
 	UpdateTile(false);
 }
 
+void GC_Wood::UpdateTiles(const FRECT &area)
+{
+	// borders change within the reach of a neighbour
+	FRECT rect = { area.left - CELL_SIZE * 2, area.top - CELL_SIZE * 2,
+	               area.right + CELL_SIZE * 2, area.bottom + CELL_SIZE * 2 };
+	FRECT frect = { rect.left / LOCATION_SIZE, rect.top / LOCATION_SIZE,
+	                rect.right / LOCATION_SIZE, rect.bottom / LOCATION_SIZE };
+
+	PtrList<ObjectList> receive;
+	g_level->grid_wood.OverlapRect(receive, frect);
+
+	std::vector<GC_Wood *> objects;
+	for( PtrList<ObjectList>::iterator rit = receive.begin(); rit != receive.end(); ++rit )
+	{
+		for( ObjectList::iterator it = (*rit)->begin(); it != (*rit)->end(); ++it )
+		{
+			GC_Wood *object = static_cast<GC_Wood *>(*it);
+			if( PtInFRect(rect, object->GetPos()) )
+			{
+				object->_tile = 0;
+				objects.push_back(object);
+			}
+		}
+	}
+
+	for( size_t i = 0; i < objects.size(); ++i )
+	{
+		objects[i]->UpdateTile(true);
+	}
+}
+
 void GC_Wood::UpdateTile(bool flag)
 {
 	static char tile1[9] = {5, 6, 7, 4,-1, 0, 3, 2, 1};
@@ -65,6 +96,13 @@ void GC_Wood::UpdateTile(bool flag)
 	///////////////////////////////////////////////////
 	FRECT frect;
 	GetGlobalRect(frect);
+
+	if( g_level->IsBatch() )
+	{
+		g_level->AddBatchArea(frect);
+		return;
+	}
+
 	frect.left   = frect.left / LOCATION_SIZE - 0.5f;
 	frect.top    = frect.top  / LOCATION_SIZE - 0.5f;
 	frect.right  = frect.right  / LOCATION_SIZE + 0.5f;
@@ -186,90 +224,159 @@ void GC_Explosion::Serialize(SaveFile &f)
 	f.Serialize(_owner);
 }
 
-float GC_Explosion::CheckDamage(FIELD_TYPE &field, float dst_x, float dst_y, float max_distance)
+///////////////////////////////////////////////////////////////////////////////
+// distances from the center of an explosion around concrete walls. the field
+// is a dense square of cells covering the blast radius; it is filled once per
+// explosion with Dijkstra's algorithm and then read for every occluded target.
+// explosions go off one at a time, so a single instance keeps its buffers.
+
+class BlastField
 {
-	int x0 = int(GetPos().x / CELL_SIZE);
-	int y0 = int(GetPos().y / CELL_SIZE);
-	int x1 = int(dst_x   / CELL_SIZE);
-	int y1 = int(dst_y   / CELL_SIZE);
+	typedef std::pair<unsigned int, int> OpenNode; // distance, cell index
 
-	std::deque<FieldNode *> open;
-	open.push_front(&field[coord(x0, y0)]);
-	open.front()->checked  = true;
-	open.front()->distance = 0;
-	open.front()->x = x0;
-	open.front()->y = y0;
+	std::vector<unsigned int>  _distance;  // UINT_MAX if not reached
+	std::vector<bool>          _blocked;
+	std::vector<OpenNode>      _open;      // heap storage
+	float _radius;
+	int _left;
+	int _top;
+	int _size;
+	bool _filled;
 
+	bool IsBlocked(int x, int y) const
+	{
+		return x < 0 || y < 0 || x >= _size || y >= _size || _blocked[x + y * _size];
+	}
 
-	while( !open.empty() )
+	static float ToReal(unsigned int distance)
 	{
-		FieldNode *node = open.back();
-		open.pop_back();
+		// horizontal step = 12; diagonal = 17
+		return (float) distance / 12.0f * (float) CELL_SIZE;
+	}
+
+	void Fill();
 
-		if( x1 == node->x && y1 == node->y )
+public:
+	// walls are collected before the explosion does any damage;
+	// the distances are calculated on the first request
+	void Prepare(const vec2d &center, float radius, PtrList<ObjectList> &receive);
+	float GetDistance(const vec2d &pos); // -1 if out of reach
+};
+
+void BlastField::Prepare(const vec2d &center, float radius, PtrList<ObjectList> &receive)
+{
+	int cx = int(center.x / CELL_SIZE);
+	int cy = int(center.y / CELL_SIZE);
+	int reach = int(radius / CELL_SIZE) + 1; // a step costs at least one cell
+	_left = cx - reach;
+	_top  = cy - reach;
+	_size = reach * 2 + 1;
+
+	_radius = radius;
+	_filled = false;
+	_blocked.assign(_size * _size, false);
+
+	for( PtrList<ObjectList>::iterator it = receive.begin(); it != receive.end(); ++it )
+	{
+		for( ObjectList::iterator cdit = (*it)->begin(); cdit != (*it)->end(); ++cdit )
 		{
-			// a path was found
-			assert(node->GetRealDistance() <= max_distance);
-			return node->GetRealDistance();
+			GC_RigidBodyStatic *object = (GC_RigidBodyStatic *) (*cdit);
+			if( GC_Wall_Concrete::GetTypeStatic() == object->GetType() )
+			{
+				int x = int(object->GetPos().x / CELL_SIZE) - _left;
+				int y = int(object->GetPos().y / CELL_SIZE) - _top;
+				if( x >= 0 && y >= 0 && x < _size && y < _size )
+					_blocked[x + y * _size] = true;
+			}
 		}
+	}
+}
 
+void BlastField::Fill()
+{
+	//
+	// check neighbors
+	//
+	//  4 | 0  | 6
+	// ---+----+---
+	//  2 |node| 3
+	// ---+----+---
+	//  7 | 1  | 5      //   0  1  2  3  4  5  6  7
+	static const int per_x[8] = {  0, 0,-1, 1,-1, 1, 1,-1 };
+	static const int per_y[8] = { -1, 1, 0, 0,-1, 1,-1, 1 };
+	static const unsigned int dist[8] = { 12,12,12,12,17,17,17,17 }; // path cost
 
+	static const int check_diag[] = { 0,2,  1,3,  3,0,  2,1 };
 
-		//
-		// check neighbors
-		//
-		//  4 | 0  | 6
-		// ---+----+---
-		//  2 |node| 3
-		// ---+----+---
-		//  7 | 1  | 5      //   0  1  2  3  4  5  6  7
-		static int per_x[8] = {  0, 0,-1, 1,-1, 1, 1,-1 };
-		static int per_y[8] = { -1, 1, 0, 0,-1, 1,-1, 1 };
-		static int dist [8] = { 12,12,12,12,17,17,17,17 }; // path cost
+	_distance.assign(_size * _size, UINT_MAX);
+	_open.clear();
 
-		static int check_diag[] = { 0,2,  1,3,  3,0,  2,1 };
+	int start = _size / 2 * (_size + 1); // the center
+	_distance[start] = 0;
+	_open.push_back(OpenNode(0, start));
 
+	while( !_open.empty() )
+	{
+		std::pop_heap(_open.begin(), _open.end(), std::greater<OpenNode>());
+		OpenNode node = _open.back();
+		_open.pop_back();
+		if( node.first > _distance[node.second] )
+		{
+			continue; // outdated entry
+		}
 
+		int x = node.second % _size;
+		int y = node.second / _size;
 		for( int i = 0; i < 8; ++i )
 		{
-			if( i > 3 )
-			if( !field[coord(node->x + per_x[check_diag[(i-4)*2  ]],
-				             node->y + per_y[check_diag[(i-4)*2  ]])].open &&
-				!field[coord(node->x + per_x[check_diag[(i-4)*2+1]],
-				             node->y + per_y[check_diag[(i-4)*2+1]])].open )
+			// a diagonal step is blocked only if both sides are blocked
+			if( i > 3 &&
+				IsBlocked(x + per_x[check_diag[(i-4)*2  ]], y + per_y[check_diag[(i-4)*2  ]]) &&
+				IsBlocked(x + per_x[check_diag[(i-4)*2+1]], y + per_y[check_diag[(i-4)*2+1]]) )
 			{
 				continue;
 			}
 
-			coord coord_(node->x + per_x[i], node->y + per_y[i]);
-			FieldNode *next = &field[coord_];
-			next->x = coord_.x;
-			next->y = coord_.y;
+			int nx = x + per_x[i];
+			int ny = y + per_y[i];
+			if( IsBlocked(nx, ny) )
+			{
+				continue;
+			}
 
-			if( next->open )
+			unsigned int d = node.first + dist[i];
+			int next = nx + ny * _size;
+			if( d < _distance[next] && ToReal(d) <= _radius )
 			{
-				if( !next->checked )
-				{
-					next->checked  = true;
-					next->parent   = node;
-					next->distance = node->distance + dist[i];
-					if( next->GetRealDistance() <= max_distance)
-						open.push_front(next);
-				}
-				else if( next->distance > node->distance + dist[i] )
-				{
-					next->parent   = node;
-					next->distance = node->distance + dist[i];
-					if( next->GetRealDistance() <= max_distance )
-						open.push_front(next);
-				}
+				_distance[next] = d;
+				_open.push_back(OpenNode(d, next));
+				std::push_heap(_open.begin(), _open.end(), std::greater<OpenNode>());
 			}
 		}
 	}
+}
+
+float BlastField::GetDistance(const vec2d &pos)
+{
+	if( !_filled )
+	{
+		Fill();
+		_filled = true;
+	}
 
-	return -1;
+	int x = int(pos.x / CELL_SIZE) - _left;
+	int y = int(pos.y / CELL_SIZE) - _top;
+	if( x < 0 || y < 0 || x >= _size || y >= _size || UINT_MAX == _distance[x + y * _size] )
+	{
+		return -1;
+	}
+	return ToReal(_distance[x + y * _size]);
 }
 
+static BlastField s_blastField;
+
+///////////////////////////////////////////////////////////////////////////////
+
 void GC_Explosion::Boom(float radius, float damage)
 {
 	FOREACH( g_level->GetList(LIST_cameras), GC_Camera, pCamera )
@@ -287,11 +394,6 @@ void GC_Explosion::Boom(float radius, float damage)
 
 	///////////////////////////////////////////////////////////
 
-	FIELD_TYPE field;
-
-	FieldNode node;
-	node.open = false;
-
 	//
 	// get a list of locations which are affected by the explosion
 	//
@@ -303,33 +405,13 @@ void GC_Explosion::Boom(float radius, float damage)
 	rt.bottom /= LOCATION_SIZE;
 	g_level->grid_rigid_s.OverlapRect(receive, rt);
 
-	//
-	// prepare the field for tracing
-	//
-	PtrList<ObjectList>::iterator it = receive.begin();
-	for( ; it != receive.end(); ++it )
-	{
-		ObjectList::iterator cdit = (*it)->begin();
-		while( (*it)->end() != cdit )
-		{
-			GC_RigidBodyStatic *pDamObject = (GC_RigidBodyStatic *) (*cdit);
-			++cdit;
-
-			if( GC_Wall_Concrete::GetTypeStatic() == pDamObject->GetType() )
-			{
-				node.x = int(pDamObject->GetPos().x / CELL_SIZE);
-				node.y = int(pDamObject->GetPos().y / CELL_SIZE);
-				field[coord(node.x, node.y)] = node;
-			}
-		}
-	}
+	s_blastField.Prepare(GetPos(), radius, receive);
 
 	//
 	// trace to the nearest objects
 	//
 
-	bool bNeedClean = false;
-	for( it = receive.begin(); it != receive.end(); ++it )
+	for( PtrList<ObjectList>::iterator it = receive.begin(); it != receive.end(); ++it )
 	{
 		FOREACH_SAFE(**it, GC_RigidBodyStatic, pDamObject)
 		{
@@ -348,14 +430,7 @@ void GC_Explosion::Boom(float radius, float damage)
 
 				if( object && object != pDamObject )
 				{
-					if( bNeedClean )
-					{
-						FIELD_TYPE::iterator it = field.begin();
-						while( it != field.end() )
-							(it++)->second.checked = false;
-					}
-					d = CheckDamage(field, pDamObject->GetPos().x, pDamObject->GetPos().y, radius);
-					bNeedClean = true;
+					d = s_blastField.GetDistance(pDamObject->GetPos());
 				}
 
 				if( d >= 0 )
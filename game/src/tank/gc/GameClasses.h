@@ -16,49 +16,11 @@ class GC_Explosion : public GC_2dSprite
 {
 	DECLARE_SELF_REGISTRATION(GC_Explosion);
 protected:
-
-	struct FieldNode
-	{
-		FieldNode *parent;
-
-		// horizontal size = 12; diagonal = 17
-		unsigned int x        : 10;
-		unsigned int y        : 10;
-		unsigned int distance : 10;
-		bool checked          :  1;
-		bool open             :  1;
-
-		FieldNode()
-		{
-			distance = 0;
-			checked  = false;
-			open     = true;
-			parent   = NULL;
-		};
-
-		float GetRealDistance() const
-		{
-			return (float) distance / 12.0f * (float) CELL_SIZE;
-		}
-	};
-
-	struct coord
-	{
-		short x, y;
-		coord() {}
-		coord(short x_, short y_) { x = x_; y = y_; }
-		operator size_t () const { return x + LEVEL_MAXSIZE * y; }
-	};
-
-	typedef std::map<coord, FieldNode> FIELD_TYPE;
-
 	bool _boomOK;
 
 	ObjPtr<GC_Player>  _owner;
 	ObjPtr<GC_Light>   _light;
 
-	float CheckDamage(FIELD_TYPE &field, float dst_x, float dst_y, float max_distance);
-
 public:
 	float _time;
 	float _time_life;
@@ -161,6 +123,9 @@ public:
 
 	void SetTile(char nTile, bool value);
 
+	// recalculates borders around the area changed within a level batch
+	static void UpdateTiles(const FRECT &area);
+
 	// GC_2dSprite
 	virtual void Draw() const;
 
@@ -40,6 +40,8 @@ GC_Light::GC_Light(enumLightType type)
   , _lightDirection(1, 0)
   , _intensity(1)
 {
+	AddContext(&g_level->grid_lights);
+	OnShapeChanged();
 	SetActive(true);
 	Update();
 }
@@ -67,6 +69,12 @@ void GC_Light::Serialize(SaveFile &f)
 	f.Serialize(_timeout);
 	f.Serialize(_type);
 	f.Serialize(_lampSprite);
+
+	if( f.loading() )
+	{
+		AddContext(&g_level->grid_lights);
+		OnShapeChanged();
+	}
 }
 
 void GC_Light::MapExchange(MapFile &f)
@@ -74,11 +82,14 @@ void GC_Light::MapExchange(MapFile &f)
 	GC_Actor::MapExchange(f);
 }
 
-void GC_Light::Shine() const
+static const MyVertex* EmitFan(const MyVertex *src, size_t nEdges)
 {
-	if( !IsActive() ) return;
-//	_FpsCounter::Inst()->OneMoreLight();
+	memcpy(g_render->DrawFan(nEdges), src, sizeof(MyVertex) * (nEdges + 1));
+	return src + nEdges + 1;
+}
 
+void GC_Light::BuildFan() const
+{
 	MyVertex *v;
 	float x,y;
 
@@ -89,7 +100,8 @@ void GC_Light::Shine() const
 	switch( _type )
 	{
 	case LIGHT_POINT:
-		v = g_render->DrawFan(SINTABLE_SIZE>>1);
+		_fan.assign((SINTABLE_SIZE>>1) + 1, MyVertex());
+		v = &_fan[0];
 		v[0].color = color;
 		v[0].x = GetPos().x;
 		v[0].y = GetPos().y;
@@ -101,7 +113,8 @@ void GC_Light::Shine() const
 		}
 		break;
 	case LIGHT_SPOT:
-		v = g_render->DrawFan(SINTABLE_SIZE);
+		_fan.assign(SINTABLE_SIZE + 1, MyVertex());
+		v = &_fan[0];
 		v[0].color = color;
 		v[0].x = GetPos().x;
 		v[0].y = GetPos().y;
@@ -115,7 +128,8 @@ void GC_Light::Shine() const
 		}
 		break;
 	case LIGHT_DIRECT:
-		v = g_render->DrawFan((SINTABLE_SIZE>>2)+4);
+		_fan.assign((SINTABLE_SIZE>>2) + 5 + (SINTABLE_SIZE>>2) + 2, MyVertex());
+		v = &_fan[0];
 		v[0].color = color;
 		v[0].x = GetPos().x;
 		v[0].y = GetPos().y;
@@ -140,7 +154,7 @@ void GC_Light::Shine() const
 		v[(SINTABLE_SIZE>>2)+4].x = GetPos().x + _radius * _lightDirection.x - _offset*_lightDirection.y;
 		v[(SINTABLE_SIZE>>2)+4].y = GetPos().y + _radius * _lightDirection.y + _offset*_lightDirection.x;
 
-		v = g_render->DrawFan((SINTABLE_SIZE>>2)+1);
+		v += (SINTABLE_SIZE>>2) + 5;
 		v[0].color = color;
 		v[0].x = GetPos().x + _radius * _lightDirection.x;
 		v[0].y = GetPos().y + _radius * _lightDirection.y;
@@ -158,10 +172,86 @@ void GC_Light::Shine() const
 	}
 }
 
+void GC_Light::Shine() const
+{
+	if( !IsActive() ) return;
+//	_FpsCounter::Inst()->OneMoreLight();
+
+	if( _fan.empty() )
+	{
+		BuildFan(); // static lights build it only once
+	}
+
+	const MyVertex *v = &_fan[0];
+	switch( _type )
+	{
+	case LIGHT_POINT:
+		EmitFan(v, SINTABLE_SIZE>>1);
+		break;
+	case LIGHT_SPOT:
+		EmitFan(v, SINTABLE_SIZE);
+		break;
+	case LIGHT_DIRECT:
+		v = EmitFan(v, (SINTABLE_SIZE>>2)+4);
+		EmitFan(v, (SINTABLE_SIZE>>2)+1);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+void GC_Light::OnShapeChanged()
+{
+	_fan.clear();
+	g_level->grid_lights_reach = std::max(g_level->grid_lights_reach, GetRenderRadius());
+}
+
+void GC_Light::SetIntensity(float i)
+{
+	_intensity = i;
+	_fan.clear();
+}
+
+void GC_Light::SetAspect(float a)
+{
+	_aspect = a;
+	_fan.clear();
+}
+
+void GC_Light::SetRadius(float r)
+{
+	if( LIGHT_DIRECT == _type )
+		_offset = r;
+	else
+		_radius = r;
+	OnShapeChanged();
+}
+
+void GC_Light::SetLightDirection(const vec2d &d)
+{
+	_lightDirection = d;
+	_fan.clear();
+}
+
+void GC_Light::SetOffset(float o)
+{
+	assert(LIGHT_DIRECT != _type);
+	_offset = o;
+	OnShapeChanged();
+}
+
+void GC_Light::SetLength(float l)
+{
+	assert(LIGHT_DIRECT == _type);
+	_radius = l;
+	OnShapeChanged();
+}
+
 void GC_Light::MoveTo(const vec2d &pos)
 {
 	_lampSprite->MoveTo(pos);
 	GC_Actor::MoveTo(pos);
+	_fan.clear();
 }
 
 void GC_Light::SetTimeout(float t)
@@ -175,6 +265,7 @@ void GC_Light::TimeStepFixed(float dt)
 {
 	assert(_timeout > 0);
 	_intensity = _intensity * (_timeout - dt) / _timeout;
+	_fan.clear();
 	_timeout -= dt;
 	if( _timeout <= 0 ) Kill();
 }
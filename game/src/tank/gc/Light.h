@@ -5,6 +5,8 @@
 #include "Object.h"
 #include "2dSprite.h"
 
+#include "video/RenderBase.h"
+
 ///////////////////////////////////////////////////////////
 // flags
 
@@ -37,10 +39,16 @@ private:
 
 	ObjPtr<GC_2dSprite> _lampSprite;
 
+	// vertices of the light fans; empty until the next Shine after any change
+	mutable std::vector<MyVertex> _fan;
+
 	static const int SINTABLE_SIZE = 32;
 	static const int SINTABLE_MASK = 0x1f;
 	static float _sintable[SINTABLE_SIZE];
 
+	void BuildFan() const;
+	void OnShapeChanged();
+
 public:
 	GC_Light(enumLightType type);
 	GC_Light(FromFile);
@@ -49,35 +57,12 @@ public:
 	virtual void Serialize(SaveFile &f);
 	virtual void MapExchange(MapFile &f);
 
-	void SetIntensity(float i)
-	{
-		_intensity = i;
-	}
-	void SetAspect(float a)
-	{
-		_aspect = a;
-	}
-	void SetRadius(float r)
-	{
-		if( LIGHT_DIRECT == _type )
-			_offset = r;
-		else
-			_radius = r;
-	}
-	void SetLightDirection(const vec2d &d)
-	{
-		_lightDirection = d;
-	}
-	void SetOffset(float o)
-	{
-		assert(LIGHT_DIRECT != _type);
-		_offset = o;
-	}
-	void SetLength(float l)
-	{
-		assert(LIGHT_DIRECT == _type);
-		_radius = l;
-	}
+	void SetIntensity(float i);
+	void SetAspect(float a);
+	void SetRadius(float r);
+	void SetLightDirection(const vec2d &d);
+	void SetOffset(float o);
+	void SetLength(float l);
 	float GetLength() const
 	{
 		assert(LIGHT_DIRECT == _type);
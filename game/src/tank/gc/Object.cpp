@@ -121,6 +121,13 @@ void ObjectProperty::AddItem(const string_t &str)
 	_value_set.push_back(str);
 }
 
+void ObjectProperty::ClearItems()
+{
+	assert(TYPE_MULTISTRING == _type);
+	_value_set.clear();
+	_value_index = 0;
+}
+
 const string_t& ObjectProperty::GetListValue(size_t index) const
 {
 	assert(TYPE_MULTISTRING == _type);
@@ -230,6 +237,11 @@ GC_Object* PropertySet::GetObject() const
 	return _object;
 }
 
+void PropertySet::Attach(GC_Object *object)
+{
+	_object = object;
+}
+
 ObjectProperty* PropertySet::GetProperty(int index)
 {
 	assert(index < GetCount());
@@ -265,6 +277,111 @@ void PropertySet::Exchange(bool applyToObject)
 		INVOKE(eventExchange)(applyToObject);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// PropertyTable class implementation
+
+std::vector<PropertyTable*> PropertyTable::_tables;
+
+struct PropertyNameLess
+{
+	PropertySet *ps;
+	bool operator () (int a, int b) const
+	{
+		return ps->GetProperty(a)->GetName() < ps->GetProperty(b)->GetName();
+	}
+};
+
+PropertyTable::PropertyTable(GC_Object *obj)
+  : _set(obj->GetProperties())
+  , _busy(false)
+{
+	_byName.resize(_set->GetCount());
+	for( int i = 0; i < _set->GetCount(); ++i )
+	{
+		_byName[i] = i;
+	}
+	PropertyNameLess pred = { _set };
+	std::sort(_byName.begin(), _byName.end(), pred);
+}
+
+int PropertyTable::FindIndex(const char *name) const
+{
+	size_t lo = 0;
+	size_t hi = _byName.size();
+	while( lo < hi )
+	{
+		size_t mid = (lo + hi) / 2;
+		int cmp = _set->GetProperty(_byName[mid])->GetName().compare(name);
+		if( 0 == cmp )
+			return _byName[mid];
+		if( cmp < 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return -1;
+}
+
+void PropertyTable::Flush()
+{
+	for( size_t i = 0; i < _tables.size(); ++i )
+	{
+		assert(!_tables[i] || !_tables[i]->_busy);
+		delete _tables[i];
+	}
+	_tables.clear();
+}
+
+PropertyTable::Binding::Binding(GC_Object *obj)
+  : _table(NULL)
+{
+	ObjectType type = obj->GetType();
+	if( _tables.size() <= (size_t) type )
+	{
+		_tables.resize(type + 1, NULL);
+	}
+	if( !_tables[type] )
+	{
+		_tables[type] = new PropertyTable(obj);
+	}
+
+	if( _tables[type]->_busy )
+	{
+		_set = obj->GetProperties();
+	}
+	else
+	{
+		_table = _tables[type];
+		_table->_busy = true;
+		_table->_set->Attach(obj);
+		_table->_set->Exchange(false);
+		_set = _table->_set;
+	}
+}
+
+PropertyTable::Binding::~Binding()
+{
+	if( _table )
+	{
+		_table->_set->Attach(NULL);
+		_table->_busy = false;
+	}
+}
+
+int PropertyTable::Binding::Find(const char *name) const
+{
+	if( _table )
+	{
+		return _table->FindIndex(name);
+	}
+	for( int i = 0; i < _set->GetCount(); ++i )
+	{
+		if( _set->GetProperty(i)->GetName() == name )
+			return i;
+	}
+	return -1;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // GC_Object class implementation
 
@@ -272,14 +389,14 @@ GC_Object::GC_Object()
   : _memberOf(this)
 //  , _refCount(1)
   , _flags(0)
-  , _firstNotify(NULL)
+  , _notify(NULL)
   , _notifyProtectCount(0)
 {
 }
 
 GC_Object::GC_Object(FromFile)
   : _memberOf(this)
-  , _firstNotify(NULL)
+  , _notify(NULL)
   , _notifyProtectCount(0)
   , _flags(0) // to clear GC_FLAG_OBJECT_KILLED & GC_FLAG_OBJECT_NAMED for proper handling of bad save files
 {
@@ -289,11 +406,17 @@ GC_Object::~GC_Object()
 {
 	assert(0 == _notifyProtectCount);
 	SetName(NULL);
-	while( _firstNotify )
+	if( _notify )
 	{
-		Notify *n = _firstNotify;
-		_firstNotify = n->next;
-		delete n;
+		for( int type = 0; type < NOTIFY_COUNT; ++type )
+		{
+			while( Notify *n = _notify->first[type] )
+			{
+				_notify->first[type] = n->next;
+				delete n;
+			}
+		}
+		delete _notify;
 	}
 //	assert(g_level->_garbage.erase(this) == 1);
 }
@@ -310,6 +433,7 @@ void GC_Object::Kill()
 }
 
 IMPLEMENT_POOLED_ALLOCATION(GC_Object::Notify);
+IMPLEMENT_POOLED_ALLOCATION(GC_Object::NotifyTable);
 
 void GC_Object::Notify::Serialize(SaveFile &f)
 {
@@ -362,30 +486,66 @@ void GC_Object::Serialize(SaveFile &f)
 		SetEvents(tmp);
 	}
 
+	if( CheckFlags(GC_FLAG_OBJECT_EVENTS_TS_FIXED) )
+	{
+		TimeStepManager::SleepState ss;
+		if( !f.loading() )
+		{
+			g_level->ts_fixed.GetSleepState(this, ss);
+		}
+		f.Serialize(ss);
+		if( f.loading() && ss.sleeping )
+		{
+			g_level->ts_fixed.SetSleepState(this, ss);
+		}
+	}
+
 
 	//
 	// notifications
 	//
 
+	// the format is the same as for a single list: the count and then records
+	// that carry their own type
 	size_t count = 0;
-	if( const Notify *n = _firstNotify )
-		do { count += !n->IsRemoved(); } while( n = n->next );
+	if( _notify )
+	{
+		for( int type = 0; type < NOTIFY_COUNT; ++type )
+			for( const Notify *n = _notify->first[type]; n; n = n->next )
+				count += !n->IsRemoved();
+	}
 	f.Serialize(count);
 	if( f.loading() )
 	{
-		assert(NULL == _firstNotify);
+		assert(NULL == _notify);
+		if( count )
+		{
+			_notify = new NotifyTable();
+		}
 		for( size_t i = 0; i < count; i++ )
 		{
-			_firstNotify = new Notify(_firstNotify);
-			_firstNotify->Serialize(f);
+			Notify tmp(NULL);
+			tmp.Serialize(f);
+			if( tmp.type < 0 || tmp.type >= NOTIFY_COUNT )
+			{
+				throw std::runtime_error("invalid notification type");
+			}
+			Notify *&first = _notify->first[tmp.type];
+			first = new Notify(first);
+			first->type = tmp.type;
+			first->subscriber = tmp.subscriber;
+			first->handler = tmp.handler;
 		}
 	}
-	else
+	else if( _notify )
 	{
-		for( Notify *n = _firstNotify; n; n = n->next )
+		for( int type = 0; type < NOTIFY_COUNT; ++type )
 		{
-			if( !n->IsRemoved() )
-				n->Serialize(f);
+			for( Notify *n = _notify->first[type]; n; n = n->next )
+			{
+				if( !n->IsRemoved() )
+					n->Serialize(f);
+			}
 		}
 	}
 }
@@ -396,14 +556,13 @@ void GC_Object::SetEvents(DWORD dwEvents)
 	if( 0 == (GC_FLAG_OBJECT_EVENTS_TS_FIXED & dwEvents) &&
 		0 != (GC_FLAG_OBJECT_EVENTS_TS_FIXED & _flags) )
 	{
-        g_level->ts_fixed.safe_erase(_itPosFixed);
+		g_level->ts_fixed.Remove(this);
 	}
 	// add to the TIMESTEP_FIXED list
 	else if( 0 != (GC_FLAG_OBJECT_EVENTS_TS_FIXED & dwEvents) &&
 			 0 == (GC_FLAG_OBJECT_EVENTS_TS_FIXED & _flags) )
 	{
-		g_level->ts_fixed.push_front(this);
-		_itPosFixed = g_level->ts_fixed.begin();
+		g_level->ts_fixed.Add(this);
 	}
 
 	//-------------------------
@@ -411,6 +570,25 @@ void GC_Object::SetEvents(DWORD dwEvents)
 	SetFlags(dwEvents, true);
 }
 
+void GC_Object::Sleep(float duration)
+{
+	assert(CheckFlags(GC_FLAG_OBJECT_EVENTS_TS_FIXED));
+	g_level->ts_fixed.Sleep(this, duration);
+}
+
+void GC_Object::WakeUp()
+{
+	if( IsSleeping() )
+	{
+		g_level->ts_fixed.WakeUp(this);
+	}
+}
+
+bool GC_Object::IsSleeping() const
+{
+	return CheckFlags(GC_FLAG_OBJECT_EVENTS_TS_FIXED) && TimeStepManager::TYPE_SLEEPING == _tsType;
+}
+
 const char* GC_Object::GetName() const
 {
 	if( CheckFlags(GC_FLAG_OBJECT_NAMED) )
@@ -457,19 +635,30 @@ void GC_Object::Subscribe(NotifyType type, GC_Object *subscriber, NOTIFYPROC han
 {
 	assert(subscriber);
 	assert(handler);
+	assert(type >= 0 && type < NOTIFY_COUNT);
 	//--------------------------------------------------
-	_firstNotify = new Notify(_firstNotify);
-	_firstNotify->type        = type;
-	_firstNotify->subscriber  = subscriber;
-	_firstNotify->handler     = handler;
+	if( !_notify )
+	{
+		_notify = new NotifyTable();
+	}
+	Notify *&first = _notify->first[type];
+	first = new Notify(first);
+	first->type        = type;
+	first->subscriber  = subscriber;
+	first->handler     = handler;
 }
 
 void GC_Object::Unsubscribe(NotifyType type, GC_Object *subscriber, NOTIFYPROC handler)
 {
 	assert(subscriber);
-	for( Notify *prev = NULL, *n = _firstNotify; n; n = n->next )
+	if( !_notify )
 	{
-		if( type == n->type && subscriber == n->subscriber && handler == n->handler )
+		assert(!"subscription not found");
+		return;
+	}
+	for( Notify *prev = NULL, *n = _notify->first[type]; n; n = n->next )
+	{
+		if( subscriber == n->subscriber && handler == n->handler )
 		{
 			if( _notifyProtectCount )
 			{
@@ -477,7 +666,7 @@ void GC_Object::Unsubscribe(NotifyType type, GC_Object *subscriber, NOTIFYPROC h
 			}
 			else
 			{
-				(prev ? prev->next : _firstNotify) = n->next;
+				(prev ? prev->next : _notify->first[type]) = n->next;
 				delete n;
 			}
 			return;
@@ -489,10 +678,15 @@ void GC_Object::Unsubscribe(NotifyType type, GC_Object *subscriber, NOTIFYPROC h
 
 void GC_Object::PulseNotify(NotifyType type, void *param)
 {
+	if( !_notify || !_notify->first[type] )
+	{
+		return;
+	}
+
 	++_notifyProtectCount;
-	for( Notify *n = _firstNotify; n; n = n->next )
+	for( Notify *n = _notify->first[type]; n; n = n->next )
 	{
-		if( type == n->type && !n->IsRemoved() )
+		if( !n->IsRemoved() )
 		{
 			((n->subscriber)->*n->handler)(this, param);
 		}
@@ -500,19 +694,23 @@ void GC_Object::PulseNotify(NotifyType type, void *param)
 	--_notifyProtectCount;
 	if( 0 == _notifyProtectCount )
 	{
-		for( Notify *prev = NULL, *n = _firstNotify; n; )
+		// subscribers of any type may have left while the handlers were running
+		for( int t = 0; t < NOTIFY_COUNT; ++t )
 		{
-			if( n->IsRemoved() )
-			{
-				Notify *&pp = prev ? prev->next : _firstNotify;
-				pp = n->next;
-				delete n;
-				n = pp;
-			}
-			else
+			for( Notify *prev = NULL, *n = _notify->first[t]; n; )
 			{
-				prev = n;
-				n = n->next;
+				if( n->IsRemoved() )
+				{
+					Notify *&pp = prev ? prev->next : _notify->first[t];
+					pp = n->next;
+					delete n;
+					n = pp;
+				}
+				else
+				{
+					prev = n;
+					n = n->next;
+				}
 			}
 		}
 	}
@@ -526,6 +724,10 @@ void GC_Object::TimeStepFloat(float dt)
 {
 }
 
+void GC_Object::OnWakeUp(float idleTime)
+{
+}
+
 void GC_Object::EditorAction()
 {
 }
@@ -72,6 +72,16 @@ public:                                         \
         {                                       \
             return _sType;                      \
         }                                       \
+        static void __TimeStepBatch(GC_Object *const *objects, size_t count, float dt) \
+        {                                       \
+            for( size_t i = 0; i < count; ++i ) \
+            {                                   \
+                if( objects[i] )                \
+                    static_cast<cls*>(objects[i])->cls::TimeStepFixed(dt); \
+                if( objects[i] )                \
+                    static_cast<cls*>(objects[i])->cls::TimeStepFloat(dt); \
+            }                                   \
+        }                                       \
     private:
 
 
@@ -162,6 +172,7 @@ public:
 	// TYPE_MULTISTRING
 	//
 	void   AddItem(const string_t &str);
+	void   ClearItems(); // also resets the current index
 	size_t GetCurrentIndex(void) const;
 	void   SetCurrentIndex(size_t index);
 	size_t GetListSize(void) const;
@@ -184,6 +195,7 @@ public:
 	void LoadFromConfig();
 	void SaveToConfig();
 	void Exchange(bool applyToObject);
+	void Attach(GC_Object *object); // rebinds a shared set to another object of the same type
 
 	Delegate<void(bool)> eventExchange;
 
@@ -191,6 +203,43 @@ public:
 	virtual ObjectProperty* GetProperty(int index);
 };
 
+// shared property set with a name index for each object type. the script
+// bindings access properties through it instead of building a new set on
+// every call; the set is only refilled from the object being accessed.
+class PropertyTable
+{
+	SafePtr<PropertySet>  _set;
+	std::vector<int>      _byName;  // property indices sorted by name
+	bool                  _busy;
+
+	PropertyTable(GC_Object *obj);
+	int FindIndex(const char *name) const;
+
+	static std::vector<PropertyTable*> _tables; // indexed by object type
+
+public:
+	// scoped access to the properties of a single object. a nested binding
+	// of the same type falls back to a private property set.
+	class Binding
+	{
+		PropertyTable         *_table;
+		SafePtr<PropertySet>   _set;
+
+		Binding(const Binding &);
+		Binding& operator = (const Binding &);
+
+	public:
+		Binding(GC_Object *obj); // fills the set with data from obj
+		~Binding();
+
+		PropertySet* operator -> () const { return _set; }
+		int Find(const char *name) const; // returns -1 if not found
+	};
+
+	// drops cached sets; property lists may depend on the level and scripts
+	static void Flush();
+};
+
 ////////////////////////////////////////////////////////////
 // object flags
 
@@ -346,6 +395,16 @@ private:
 		explicit Notify(Notify *nxt) : next(nxt) {}
 	};
 
+	// subscribers grouped by notification type; allocated on first subscription
+	// so that pulsing a type nobody listens to costs a single check
+	struct NotifyTable
+	{
+		DECLARE_POOLED_ALLOCATION(NotifyTable);
+
+		Notify *first[NOTIFY_COUNT];
+		NotifyTable() { memset(first, 0, sizeof(first)); }
+	};
+
 
 	//
 	// attributes
@@ -354,9 +413,11 @@ private:
 private:
 	DWORD           _flags;             // define various object properties
 
-	ObjectList::iterator _itPosFixed;      // position in the Level::ts_fixed
+	friend class TimeStepManager;
+	int _tsType;   // group in the Level::ts_fixed, INVALID_OBJECT_TYPE if not sorted yet or TYPE_SLEEPING
+	int _tsSlot;   // position in the group
 
-	Notify *_firstNotify;
+	NotifyTable *_notify;
 	int  _notifyProtectCount;
 
 public:
@@ -397,8 +458,14 @@ public:
 protected:
 	void PulseNotify(NotifyType type, void *param = NULL);
 
+	// leave the time step until WakeUp is called or the duration runs out;
+	// the object must be able to catch up in OnWakeUp
+	void Sleep(float duration = -1);
+
 public:
 	void SetEvents(DWORD dwEvents);
+	void WakeUp();
+	bool IsSleeping() const;
 
 	const char* GetName() const;
 	void SetName(const char *name);
@@ -440,6 +507,7 @@ public:
 
 	virtual void TimeStepFixed(float dt);
 	virtual void TimeStepFloat(float dt);
+	virtual void OnWakeUp(float idleTime);
 	virtual void EditorAction();
 
 	virtual void MapExchange(MapFile &f);
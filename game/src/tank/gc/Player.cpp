@@ -303,6 +303,15 @@ GC_Player::MyPropertySet::MyPropertySet(GC_Object *object)
 {
 	_propTeam.SetIntRange(0, MAX_TEAMS);
 	_propScore.SetIntRange(INT_MIN, INT_MAX);
+	FillLists();
+}
+
+// scripts and themes may add classes and skins while the set is cached
+// by PropertyTable, so the lists are refilled whenever it is bound
+void GC_Player::MyPropertySet::FillLists()
+{
+	_propClass.ClearItems();
+	_propSkin.ClearItems();
 
 	lua_getglobal(g_env.L, "classes");
 	for( lua_pushnil(g_env.L); lua_next(g_env.L, -2); lua_pop(g_env.L, 1) )
@@ -390,6 +399,7 @@ void GC_Player::MyPropertySet::MyExchange(bool applyToObject)
 		_propNick.SetStringValue(tmp->GetNick());
 		_propVehName.SetStringValue(tmp->_vehname);
 
+		FillLists(); // resets both indices, so no value is left from another player
 		for( size_t i = 0; i < _propClass.GetListSize(); ++i )
 		{
 			if( tmp->GetClass() == _propClass.GetListValue(i) )
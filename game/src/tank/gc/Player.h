@@ -48,6 +48,8 @@ protected:
 		ObjectProperty _propOnRespawn;
 		ObjectProperty _propVehName;
 
+		void FillLists();
+
 	public:
 		MyPropertySet(GC_Object *object);
 		virtual int GetCount() const;
@@ -854,11 +854,7 @@ void GC_Wall::Serialize(SaveFile &f)
 				y = int(p.y);
 				break;
 			}
-			g_level->_field(x, y).RemoveObject(this);
-			if( 0 == x || 0 == y || g_level->_field.GetX() - 1 == x || g_level->_field.GetX() - 1 == y )
-			{
-				g_level->_field(x, y)._prop = 0xFF;
-			}
+			g_level->_field.RemoveObject(x, y, this);
 		}
 	}
 }
@@ -944,7 +940,7 @@ void GC_Wall::SetCorner(unsigned int index) // 0 means normal view
 			y = int(p.y);
 			break;
 		}
-		g_level->_field(x, y).AddObject(this);
+		g_level->_field.AddObject(x, y, this);
 	}
 
 	SetFlags(GC_FLAG_WALL_CORNER_ALL, false);
@@ -978,11 +974,7 @@ void GC_Wall::SetCorner(unsigned int index) // 0 means normal view
 			y = int(p.y);
 			break;
 		}
-		g_level->_field(x, y).RemoveObject(this);
-		if( 0 == x || 0 == y || g_level->_field.GetX() - 1 == x || g_level->_field.GetX() - 1 == y )
-		{
-			g_level->_field(x, y)._prop = 0xFF;
-		}
+		g_level->_field.RemoveObject(x, y, this);
 	}
 }
 
@@ -1187,6 +1179,37 @@ GC_Water::~GC_Water()
     UpdateTile(false);
 }
 
+void GC_Water::UpdateTiles(const FRECT &area)
+{
+	// borders change within the reach of a neighbour
+	FRECT rect = { area.left - CELL_SIZE * 2, area.top - CELL_SIZE * 2,
+	               area.right + CELL_SIZE * 2, area.bottom + CELL_SIZE * 2 };
+	FRECT frect = { rect.left / LOCATION_SIZE, rect.top / LOCATION_SIZE,
+	                rect.right / LOCATION_SIZE, rect.bottom / LOCATION_SIZE };
+
+	PtrList<ObjectList> receive;
+	g_level->grid_water.OverlapRect(receive, frect);
+
+	std::vector<GC_Water *> objects;
+	for( PtrList<ObjectList>::iterator rit = receive.begin(); rit != receive.end(); ++rit )
+	{
+		for( ObjectList::iterator it = (*rit)->begin(); it != (*rit)->end(); ++it )
+		{
+			GC_Water *object = static_cast<GC_Water *>(*it);
+			if( PtInFRect(rect, object->GetPos()) )
+			{
+				object->_tile = 0;
+				objects.push_back(object);
+			}
+		}
+	}
+
+	for( size_t i = 0; i < objects.size(); ++i )
+	{
+		objects[i]->UpdateTile(true);
+	}
+}
+
 void GC_Water::UpdateTile(bool flag)
 {
 	static char tile1[9] = {5, 6, 7, 4,-1, 0, 3, 2, 1};
@@ -1194,6 +1217,13 @@ void GC_Water::UpdateTile(bool flag)
 	///////////////////////////////////////////////////
 	FRECT frect;
 	GetGlobalRect(frect);
+
+	if( g_level->IsBatch() )
+	{
+		g_level->AddBatchArea(frect);
+		return;
+	}
+
 	frect.left   = frect.left / LOCATION_SIZE - 0.5f;
 	frect.top    = frect.top  / LOCATION_SIZE - 0.5f;
 	frect.right  = frect.right  / LOCATION_SIZE + 0.5f;
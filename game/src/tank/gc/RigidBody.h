@@ -243,6 +243,9 @@ public:
 
 	void SetTile(char nTile, bool value);
 
+	// recalculates borders around the area changed within a level batch
+	static void UpdateTiles(const FRECT &area);
+
 	virtual void Serialize(SaveFile &f);
 
 	virtual void Draw() const;
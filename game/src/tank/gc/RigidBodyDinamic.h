@@ -12,8 +12,13 @@
 #define GC_FLAG_RBDYMAMIC_          (GC_FLAG_RBSTATIC_ << 2)
 
 
-class GC_RigidBodyDynamic : public GC_RigidBodyStatic
+class GC_RigidBodyDynamic;
+
+// collision state of a single level; owned by the Level
+class RigidBodyContacts
 {
+	friend class GC_RigidBodyDynamic;
+
 	struct Contact
 	{
 		ObjPtr<GC_RigidBodyDynamic> obj1_d;
@@ -26,9 +31,18 @@ class GC_RigidBodyDynamic : public GC_RigidBodyStatic
 	};
 
 	typedef std::vector<Contact> ContactList;
-	static ContactList _contacts;
-	static std::stack<ContactList> _contactsStack;
-	static bool _glob_parity;
+	ContactList _contacts;
+	std::stack<ContactList> _contactsStack;
+	bool _glob_parity;
+
+public:
+	RigidBodyContacts() : _glob_parity(false) {}
+};
+
+class GC_RigidBodyDynamic : public GC_RigidBodyStatic
+{
+	typedef RigidBodyContacts::Contact Contact;
+	typedef RigidBodyContacts::ContactList ContactList;
 
 	float geta_s(const vec2d &n, const vec2d &c, const GC_RigidBodyStatic *obj) const;
 	float geta_d(const vec2d &n, const vec2d &c, const GC_RigidBodyDynamic *obj) const;
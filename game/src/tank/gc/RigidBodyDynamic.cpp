@@ -5,6 +5,8 @@
 #include "Projectiles.h"
 #include "Sound.h"
 
+#include "core/DetMath.h"
+
 #include "fs/SaveFile.h"
 #include "fs/MapFile.h"
 
@@ -91,10 +93,6 @@ void GC_RigidBodyDynamic::MyPropertySet::MyExchange(bool applyToObject)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-GC_RigidBodyDynamic::ContactList GC_RigidBodyDynamic::_contacts;
-std::stack<GC_RigidBodyDynamic::ContactList> GC_RigidBodyDynamic::_contactsStack;
-bool GC_RigidBodyDynamic::_glob_parity = false;
-
 GC_RigidBodyDynamic::GC_RigidBodyDynamic()
   : GC_RigidBodyStatic()
 {
@@ -121,7 +119,7 @@ GC_RigidBodyDynamic::GC_RigidBodyDynamic()
 	_external_torque = 0;
 
 
-	if( _glob_parity ) SetFlags(GC_FLAG_RBDYMAMIC_PARITY, true);
+	if( g_level->contacts->_glob_parity ) SetFlags(GC_FLAG_RBDYMAMIC_PARITY, true);
 	SetEvents(GC_FLAG_OBJECT_EVENTS_TS_FIXED);
 }
 
@@ -184,9 +182,9 @@ float GC_RigidBodyDynamic::GetSpinup() const
 		if( _Nw > 0 )
 		{
 			if( _av > 0 )
-				result = (_av - log(1 + _av * _Mw/_Nw) * _Nw/_Mw) / _Mw;
+				result = (_av - DetLog(1 + _av * _Mw/_Nw) * _Nw/_Mw) / _Mw;
 			else
-				result = (_av + log(1 - _av * _Mw/_Nw) * _Nw/_Mw) / _Mw;
+				result = (_av + DetLog(1 - _av * _Mw/_Nw) * _Nw/_Mw) / _Mw;
 		}
 		else
 		{
@@ -210,9 +208,9 @@ vec2d GC_RigidBodyDynamic::GetBrakingLength() const
 		if( _Nx > 0 )
 		{
 			if( vx > 0 )
-				result = vx/_Mx - _Nx/(_Mx*_Mx)*(log(_Nx + _Mx*vx)-log(_Nx));
+				result = vx/_Mx - _Nx/(_Mx*_Mx)*(DetLog(_Nx + _Mx*vx)-DetLog(_Nx));
 			else
-				result = vx/_Mx + _Nx/(_Mx*_Mx)*(log(_Nx - _Mx*vx)-log(_Nx));
+				result = vx/_Mx + _Nx/(_Mx*_Mx)*(DetLog(_Nx - _Mx*vx)-DetLog(_Nx));
 		}
 		else
 		{
@@ -265,13 +263,13 @@ void GC_RigidBodyDynamic::TimeStepFixed(float dt)
 		vx = __max(0, vx - _Nx * dt * dev.x);
 	else
 		vx = __min(0, vx - _Nx * dt * dev.x);
-	vx *= expf(-_Mx * dt);
+	vx *= DetExp(-_Mx * dt);
 
 	if( vy > 0 )
 		vy = __max(0, vy - _Ny * dt * dev.y);
 	else
 		vy = __min(0, vy - _Ny * dt * dev.y);
-	vy *= expf(-_My * dt);
+	vy *= DetExp(-_My * dt);
 
 	_lv = GetDirection() * vx + dir_y * vy;
 
@@ -281,7 +279,7 @@ void GC_RigidBodyDynamic::TimeStepFixed(float dt)
 	//
 	if( _Mw > 0 )
 	{
-		float e = expf(-_Mw * dt);
+		float e = DetExp(-_Mw * dt);
 		float nm = _Nw / _Mw * (e - 1);
 		if( _av > 0 )
 			_av = __max(0, _av * e + nm);
@@ -343,7 +341,7 @@ void GC_RigidBodyDynamic::TimeStepFixed(float dt)
 				c.obj2_s = object;
 				c.obj2_d = PtrDynCast<GC_RigidBodyDynamic>(object);
 
-				_contacts.push_back(c);
+				g_level->contacts->_contacts.push_back(c);
 			}
 		}
 	}
@@ -372,21 +370,24 @@ float GC_RigidBodyDynamic::geta_d(const vec2d &n, const vec2d &c, const GC_Rigid
 
 void GC_RigidBodyDynamic::PushState()
 {
-	_contactsStack.push(ContactList());
-	_contactsStack.top().swap(_contacts);
+	RigidBodyContacts &rbc = *g_level->contacts;
+	rbc._contactsStack.push(ContactList());
+	rbc._contactsStack.top().swap(rbc._contacts);
 }
 
 void GC_RigidBodyDynamic::PopState()
 {
-	_contactsStack.top().swap(_contacts);
-	_contactsStack.pop();
+	RigidBodyContacts &rbc = *g_level->contacts;
+	rbc._contactsStack.top().swap(rbc._contacts);
+	rbc._contactsStack.pop();
 }
 
 void GC_RigidBodyDynamic::ProcessResponse(float dt)
 {
+	ContactList &contacts = g_level->contacts->_contacts;
 	for( int i = 0; i < 128; i++ )
 	{
-		for( ContactList::iterator it = _contacts.begin(); it != _contacts.end(); ++it )
+		for( ContactList::iterator it = contacts.begin(); it != contacts.end(); ++it )
 		{
 			if( !it->obj1_d || !it->obj2_s ) continue;
 
@@ -463,7 +464,7 @@ void GC_RigidBodyDynamic::ProcessResponse(float dt)
 		}
 	}
 
-	for( ContactList::iterator it = _contacts.begin(); it != _contacts.end(); ++it )
+	for( ContactList::iterator it = contacts.begin(); it != contacts.end(); ++it )
 	{
 		float nd = (it->total_np + it->total_tp)/60;
 
@@ -480,11 +481,12 @@ void GC_RigidBodyDynamic::ProcessResponse(float dt)
 		}
 	}
 
-	_contacts.clear();
+	contacts.clear();
 }
 
 void GC_RigidBodyDynamic::impulse(const vec2d &origin, const vec2d &impulse)
 {
+	WakeUp();
 	_lv += impulse * _inv_m;
 	_av += ((origin.x-GetPos().x)*impulse.y-(origin.y-GetPos().y)*impulse.x) * _inv_i;
 	assert(!_isnan(_av) && _finite(_av));
@@ -492,23 +494,27 @@ void GC_RigidBodyDynamic::impulse(const vec2d &origin, const vec2d &impulse)
 
 void GC_RigidBodyDynamic::ApplyMomentum(float momentum)
 {
+	WakeUp();
 	_external_momentum += momentum;
 	assert(!_isnan(_external_momentum) && _finite(_external_momentum));
 }
 
 void GC_RigidBodyDynamic::ApplyForce(const vec2d &force)
 {
+	WakeUp();
 	_external_force += force;
 }
 
 void GC_RigidBodyDynamic::ApplyForce(const vec2d &force, const vec2d &origin)
 {
+	WakeUp();
 	_external_force += force;
 	_external_momentum += (origin.x-GetPos().x)*force.y-(origin.y-GetPos().y)*force.x;
 }
 
 void GC_RigidBodyDynamic::ApplyImpulse(const vec2d &impulse, const vec2d &origin)
 {
+	WakeUp();
 	_external_impulse += impulse;
 	_external_torque  += (origin.x-GetPos().x)*impulse.y-(origin.y-GetPos().y)*impulse.x;
 	assert(!_isnan(_external_torque) && _finite(_external_torque));
@@ -516,11 +522,13 @@ void GC_RigidBodyDynamic::ApplyImpulse(const vec2d &impulse, const vec2d &origin
 
 void GC_RigidBodyDynamic::ApplyImpulse(const vec2d &impulse)
 {
+	WakeUp();
 	_external_impulse += impulse;
 }
 
 void GC_RigidBodyDynamic::ApplyTorque(float torque)
 {
+	WakeUp();
 	_external_torque  += torque;
 	assert(!_isnan(_external_torque) && _finite(_external_torque));
 }
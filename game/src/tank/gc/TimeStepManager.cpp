@@ -0,0 +1,274 @@
+// TimeStepManager.cpp
+
+#include "stdafx.h"
+#include "TimeStepManager.h"
+#include "Object.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+TimeStepManager::TimeStepManager()
+  : _count(0)
+  , _sleeping(0)
+  , _seq(0)
+  , _time(0)
+  , _stepping(false)
+{
+}
+
+TimeStepManager::~TimeStepManager()
+{
+	assert(0 == _count);
+}
+
+void TimeStepManager::Attach(GC_Object *obj)
+{
+	obj->_tsType = INVALID_OBJECT_TYPE;
+	obj->_tsSlot = (int) _pending.size();
+	_pending.push_back(obj);
+}
+
+void TimeStepManager::Detach(GC_Object *obj)
+{
+	if( INVALID_OBJECT_TYPE == obj->_tsType )
+	{
+		assert(_pending[obj->_tsSlot] == obj);
+		_pending[obj->_tsSlot] = NULL;
+	}
+	else if( TYPE_SLEEPING == obj->_tsType )
+	{
+		assert(_sleepers[obj->_tsSlot].obj == obj);
+		_sleepers[obj->_tsSlot].obj = NULL;
+		_freeSleepers.push_back(obj->_tsSlot);
+		--_sleeping;
+	}
+	else
+	{
+		Group &g = _groups[obj->_tsType];
+		assert(g.objects[obj->_tsSlot] == obj);
+		g.objects[obj->_tsSlot] = NULL;
+		++g.holes;
+	}
+}
+
+void TimeStepManager::Add(GC_Object *obj)
+{
+	assert(obj);
+	Attach(obj);
+	++_count;
+}
+
+void TimeStepManager::Remove(GC_Object *obj)
+{
+	Detach(obj);
+	if( 0 == --_count && !_stepping )
+	{
+		Reset();
+	}
+}
+
+void TimeStepManager::Sleep(GC_Object *obj, float duration)
+{
+	assert(TYPE_SLEEPING != obj->_tsType);
+	Detach(obj);
+
+	int slot;
+	if( _freeSleepers.empty() )
+	{
+		slot = (int) _sleepers.size();
+		_sleepers.push_back(Sleeper());
+	}
+	else
+	{
+		slot = _freeSleepers.back();
+		_freeSleepers.pop_back();
+	}
+
+	Sleeper &s = _sleepers[slot];
+	s.obj = obj;
+	s.since = _time;
+	s.wake = duration >= 0 ? _time + duration : -1;
+	s.seq = ++_seq;
+	obj->_tsType = TYPE_SLEEPING;
+	obj->_tsSlot = slot;
+	++_sleeping;
+
+	if( s.wake >= 0 )
+	{
+		Alarm a;
+		a.time = s.wake;
+		a.seq = s.seq;
+		a.slot = slot;
+		_alarms.push(a);
+	}
+}
+
+void TimeStepManager::WakeUp(GC_Object *obj)
+{
+	assert(TYPE_SLEEPING == obj->_tsType);
+	float idle = _time - _sleepers[obj->_tsSlot].since;
+	Detach(obj);
+	Attach(obj);
+	obj->OnWakeUp(idle);
+}
+
+void TimeStepManager::GetSleepState(const GC_Object *obj, SleepState &ss) const
+{
+	ss.sleeping = (TYPE_SLEEPING == obj->_tsType);
+	if( ss.sleeping )
+	{
+		const Sleeper &s = _sleepers[obj->_tsSlot];
+		ss.since = s.since;
+		ss.wake = s.wake;
+		ss.seq = s.seq;
+	}
+	else
+	{
+		ss.since = 0;
+		ss.wake = -1;
+		ss.seq = 0;
+	}
+}
+
+void TimeStepManager::SetSleepState(GC_Object *obj, const SleepState &ss)
+{
+	assert(ss.sleeping);
+	Sleep(obj, -1);
+
+	// the saved times and sequence number keep the alarms in the same order
+	// as on the peers that did not save
+	Sleeper &s = _sleepers[obj->_tsSlot];
+	s.since = ss.since;
+	s.wake = ss.wake;
+	s.seq = ss.seq;
+	_seq = std::max(_seq, ss.seq);
+
+	if( s.wake >= 0 )
+	{
+		Alarm a;
+		a.time = s.wake;
+		a.seq = s.seq;
+		a.slot = obj->_tsSlot;
+		_alarms.push(a);
+	}
+}
+
+void TimeStepManager::SetTime(float time)
+{
+	assert(0 == _count);
+	_time = time;
+}
+
+void TimeStepManager::Reset()
+{
+	for( size_t i = 0; i < _groups.size(); ++i )
+	{
+		_groups[i].objects.clear();
+		_groups[i].holes = 0;
+	}
+	_pending.clear();
+	_sleepers.clear();
+	_freeSleepers.clear();
+	_alarms = std::priority_queue<Alarm, std::vector<Alarm>, std::greater<Alarm> >();
+	_seq = 0;
+	_time = 0;
+}
+
+void TimeStepManager::Compact()
+{
+	for( size_t type = 0; type < _groups.size(); ++type )
+	{
+		Group &g = _groups[type];
+		if( !g.holes )
+			continue;
+
+		size_t n = 0;
+		for( size_t i = 0; i < g.objects.size(); ++i )
+		{
+			if( GC_Object *obj = g.objects[i] )
+			{
+				obj->_tsSlot = (int) n;
+				g.objects[n++] = obj;
+			}
+		}
+		g.objects.resize(n);
+		g.holes = 0;
+	}
+
+	for( size_t i = 0; i < _pending.size(); ++i )
+	{
+		if( GC_Object *obj = _pending[i] )
+		{
+			ObjectType type = obj->GetType();
+			if( _groups.size() <= (size_t) type )
+			{
+				_groups.resize(type + 1);
+			}
+			obj->_tsType = type;
+			obj->_tsSlot = (int) _groups[type].objects.size();
+			_groups[type].objects.push_back(obj);
+		}
+	}
+	_pending.clear();
+}
+
+void TimeStepManager::Step(float dt)
+{
+	assert(!_stepping);
+
+	// objects whose alarm goes off during this step take part in it
+	while( !_alarms.empty() && _alarms.top().time <= _time + dt )
+	{
+		Alarm a = _alarms.top();
+		_alarms.pop();
+		if( _sleepers[a.slot].obj && _sleepers[a.slot].seq == a.seq )
+		{
+			WakeUp(_sleepers[a.slot].obj);
+		}
+	}
+	_time += dt;
+
+	Compact();
+
+	_stepping = true;
+	for( size_t type = 0; type < _groups.size(); ++type )
+	{
+		// the group does not grow during the step, new objects wait in _pending
+		Group &g = _groups[type];
+		if( !g.objects.empty() )
+		{
+			RTTypes::Inst().GetTimeStepBatch(type)(&g.objects[0], g.objects.size(), dt);
+		}
+	}
+	_stepping = false;
+
+	if( 0 == _count )
+	{
+		Reset();
+	}
+}
+
+void TimeStepManager::GetObjects(std::vector<GC_Object*> &result) const
+{
+	for( size_t type = 0; type < _groups.size(); ++type )
+	{
+		const Group &g = _groups[type];
+		for( size_t i = 0; i < g.objects.size(); ++i )
+		{
+			if( g.objects[i] )
+				result.push_back(g.objects[i]);
+		}
+	}
+	for( size_t i = 0; i < _pending.size(); ++i )
+	{
+		if( _pending[i] )
+			result.push_back(_pending[i]);
+	}
+	for( size_t i = 0; i < _sleepers.size(); ++i )
+	{
+		if( _sleepers[i].obj )
+			result.push_back(_sleepers[i].obj);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,99 @@
+// TimeStepManager.h
+
+#pragma once
+
+class GC_Object;
+
+///////////////////////////////////////////////////////////////////////////////
+// objects receiving time step events grouped by their concrete type. each
+// group is updated by a single non-virtual batch function of the type. groups
+// go in the order of type registration and objects within a group in the order
+// they were added, so the result is the same on all network peers.
+//
+// objects added during a step start working from the next one. removed objects
+// leave an empty slot until the group is compacted before the next step.
+//
+// an idle object may fall asleep and leave the step until it is woken up
+// explicitly or by its alarm. on wake up the object is told how long it slept.
+
+class TimeStepManager
+{
+	struct Group
+	{
+		std::vector<GC_Object*> objects;
+		size_t holes;
+		Group() : holes(0) {}
+	};
+
+	struct Sleeper
+	{
+		GC_Object    *obj;     // NULL if the slot is free
+		float         since;
+		float         wake;    // time of the alarm or negative if there is none
+		unsigned int  seq;     // distinguishes alarms of the previous owners of the slot
+	};
+
+	struct Alarm
+	{
+		float         time;
+		unsigned int  seq;     // keeps the order of equal alarms the same on all peers
+		int           slot;
+		bool operator > (const Alarm &other) const
+		{
+			return time > other.time || (time == other.time && seq > other.seq);
+		}
+	};
+
+	std::vector<Group>      _groups;    // indexed by object type
+	std::vector<GC_Object*> _pending;   // type is not known until the constructor finishes
+	std::vector<Sleeper>    _sleepers;
+	std::vector<int>        _freeSleepers;
+	std::priority_queue<Alarm, std::vector<Alarm>, std::greater<Alarm> > _alarms;
+	size_t       _count;
+	size_t       _sleeping;
+	unsigned int _seq;
+	float        _time;
+	bool         _stepping;
+
+	void Attach(GC_Object *obj);
+	void Detach(GC_Object *obj);
+	void Compact();
+	void Reset();
+
+public:
+	enum { TYPE_SLEEPING = -2 }; // GC_Object::_tsType of sleeping objects
+
+	// what a saved game needs to put an object asleep exactly as it was
+	struct SleepState
+	{
+		bool          sleeping;
+		float         since;
+		float         wake;
+		unsigned int  seq;
+	};
+
+	TimeStepManager();
+	~TimeStepManager();
+
+	void Add(GC_Object *obj);
+	void Remove(GC_Object *obj);
+
+	void Sleep(GC_Object *obj, float duration); // negative duration means until WakeUp
+	void WakeUp(GC_Object *obj);
+
+	void GetSleepState(const GC_Object *obj, SleepState &ss) const;
+	void SetSleepState(GC_Object *obj, const SleepState &ss); // for objects being loaded
+
+	// sleep and alarm times are measured by this clock
+	float GetTime() const { return _time; }
+	void SetTime(float time); // only while empty
+
+	void Step(float dt);
+
+	size_t size() const { return _count; }
+	size_t GetSleepingCount() const { return _sleeping; }
+	void GetObjects(std::vector<GC_Object*> &result) const; // in update order, sleeping objects last
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -110,9 +110,11 @@ void GC_Trigger::TimeStepFixed(float dt)
 		assert(!_veh);
 
 		// find nearest vehicle
-		float rr_min = _radius * _radius * CELL_SIZE * CELL_SIZE;
-		FOREACH( g_level->GetList(LIST_vehicles), GC_Vehicle, veh )
+		std::vector<GC_Vehicle*> candidates;
+		g_level->QueryVehicles(GetPos(), _radius * CELL_SIZE, candidates);
+		for( size_t i = 0; i < candidates.size() && !_veh; ++i )
 		{
+			GC_Vehicle *veh = candidates[i];
 			if( !veh->GetOwner() 
 				|| CheckFlags(GC_FLAG_TRIGGER_ONLYHUMAN) 
 					&& dynamic_cast<GC_PlayerAI*>(veh->GetOwner()) )
@@ -124,15 +126,11 @@ void GC_Trigger::TimeStepFixed(float dt)
 				continue;
 			}
 			float rr = (GetPos() - veh->GetPos()).sqr();
-			if( rr < rr_min )
+			if( CheckFlags(GC_FLAG_TRIGGER_ONLYVISIBLE) && rr > veh->GetRadius() * veh->GetRadius() )
 			{
-				if( CheckFlags(GC_FLAG_TRIGGER_ONLYVISIBLE) && rr > veh->GetRadius() * veh->GetRadius() )
-				{
-					if( !GetVisible(veh) ) continue; // vehicle is invisible. skipping
-				}
-				rr_min = rr;
-				_veh = veh;
+				if( !GetVisible(veh) ) continue; // vehicle is invisible. skipping
 			}
+			_veh = veh;
 		}
 		if( _veh )
 		{
@@ -7,7 +7,6 @@
 #include "level.h"
 #include "functions.h"
 
-#include "core/JobManager.h"
 #include "core/debug.h"
 
 #include "fs/MapFile.h"
@@ -23,8 +22,6 @@
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
-JobManager<GC_Turret> GC_Turret::_jobManager;
-
 GC_Turret::GC_Turret(float x, float y, const char *tex)
   : GC_RigidBodyStatic()
   , _rotator(_dir)
@@ -37,7 +34,7 @@ GC_Turret::GC_Turret(float x, float y, const char *tex)
 	SetTexture(tex);
 	AlignToTexture();
 
-	_jobManager.RegisterMember(this);
+	_jobTicket = g_level->jobs_turret.RegisterMember(this);
 	_state = TS_WAITING;
 	_rotator.reset(0, 0, 2.0f, 5.0f, 10.0f);
 
@@ -64,7 +61,7 @@ GC_Turret::~GC_Turret()
 
 	if( TS_WAITING == _state || TS_HIDDEN == _state )
 	{
-		_jobManager.UnregisterMember(this);
+		g_level->jobs_turret.UnregisterMember(_jobTicket);
 	}
 }
 
@@ -85,42 +82,39 @@ void GC_Turret::Serialize(SaveFile &f)
 
 	if( f.loading() && (TS_WAITING == _state || TS_HIDDEN == _state) )
 	{
-		_jobManager.RegisterMember(this);
+		_jobTicket = g_level->jobs_turret.RegisterMember(this);
 	}
 }
 
 GC_Vehicle* GC_Turret::EnumTargets()
 {
-	float min_dist = _sight*_sight;
-	float dist;
-
-	GC_Vehicle *target = NULL;
 	GC_RigidBodyStatic *pObstacle = NULL;
 
-	FOREACH( g_level->GetList(LIST_vehicles), GC_Vehicle, pDamObj )
+	std::vector<GC_Vehicle*> candidates;
+	g_level->QueryVehicles(GetPos(), _sight, candidates);
+
+	for( size_t i = 0; i < candidates.size(); ++i )
 	{
+		GC_Vehicle *pDamObj = candidates[i];
 		if( !pDamObj->GetOwner() ||
 			pDamObj->GetOwner()->GetTeam() && pDamObj->GetOwner()->GetTeam() == _team )
 		{
 			continue;
 		}
 
-		dist = (GetPos().x - pDamObj->GetPos().x)*(GetPos().x - pDamObj->GetPos().x)
-				+ (GetPos().y - pDamObj->GetPos().y)*(GetPos().y - pDamObj->GetPos().y);
-
-		if( dist < min_dist && IsTargetVisible(pDamObj, &pObstacle) )
+		// candidates are sorted by distance so the first visible one is the nearest
+		if( IsTargetVisible(pDamObj, &pObstacle) )
 		{
-			target = pDamObj;
-			min_dist = dist;
+			return pDamObj;
 		}
 	}
 
-	return target;
+	return NULL;
 }
 
 void GC_Turret::SelectTarget(GC_Vehicle *target)
 {
-	_jobManager.UnregisterMember(this);
+	g_level->jobs_turret.UnregisterMember(_jobTicket);
 	_target = target;
 	_state   = TS_ATACKING;
 	PLAY(SND_TargetLock, GetPos());
@@ -128,7 +122,7 @@ void GC_Turret::SelectTarget(GC_Vehicle *target)
 
 void GC_Turret::TargetLost()
 {
-	_jobManager.RegisterMember(this);
+	_jobTicket = g_level->jobs_turret.RegisterMember(this);
 	_target = NULL;
 	_state  = TS_WAITING;
 }
@@ -169,7 +163,7 @@ void GC_Turret::TimeStepFixed(float dt)
 	switch( _state )
 	{
 	case TS_WAITING:
-		if( _jobManager.TakeJob(this) )
+		if( g_level->jobs_turret.TakeJob(_jobTicket, g_level->GetTime()) )
 		{
 			if( GC_Vehicle *target = EnumTargets() )
 				SelectTarget(target);
@@ -483,7 +477,7 @@ GC_TurretBunker::~GC_TurretBunker()
 
 void GC_TurretBunker::WakeUp()
 {
-	_jobManager.UnregisterMember(this);
+	g_level->jobs_turret.UnregisterMember(_jobTicket);
 	_state = TS_WAKING_UP;
 	PLAY(SND_TuretWakeUp, GetPos());
 }
@@ -491,7 +485,7 @@ void GC_TurretBunker::WakeUp()
 void GC_TurretBunker::WakeDown()
 {
 	_state = TS_PREPARE_TO_WAKEDOWN;
-	_jobManager.UnregisterMember(this);
+	g_level->jobs_turret.UnregisterMember(_jobTicket);
 }
 
 bool GC_TurretBunker::TakeDamage(float damage, const vec2d &hit, GC_Player *from)
@@ -560,7 +554,7 @@ void GC_TurretBunker::TimeStepFixed(float dt)
 		}
 		else
 		{
-		//	if( _jobManager.TakeJob(this) )
+		//	if( g_level->jobs_turret.TakeJob(_jobTicket, g_level->GetTime()) )
 			{
 				if( GC_Vehicle *target = EnumTargets() )
 					SelectTarget(target);
@@ -569,7 +563,7 @@ void GC_TurretBunker::TimeStepFixed(float dt)
 		break;
 
 	case TS_HIDDEN:
-		if( _jobManager.TakeJob(this) )
+		if( g_level->jobs_turret.TakeJob(_jobTicket, g_level->GetTime()) )
 		{
 			if( EnumTargets() ) WakeUp();
 		}
@@ -581,7 +575,7 @@ void GC_TurretBunker::TimeStepFixed(float dt)
 		{
 			_time_wake = _time_wake_max;
 			_state = TS_WAITING;
-			_jobManager.RegisterMember(this);
+			_jobTicket = g_level->jobs_turret.RegisterMember(this);
 			_weaponSprite->SetVisible(true);
 			SetFrame(GetFrameCount() - 1);
 		}
@@ -598,7 +592,7 @@ void GC_TurretBunker::TimeStepFixed(float dt)
 			_time_wake = 0;
 			_state = TS_HIDDEN;
 			SetFrame(0);
-			_jobManager.RegisterMember(this);
+			_jobTicket = g_level->jobs_turret.RegisterMember(this);
 		}
 		else
 			SetFrame(int( (float)(GetFrameCount() - 1) * _time_wake / _time_wake_max ));
@@ -8,7 +8,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 // forward declarations
 
-template<class T> class JobManager;
 class GC_Vehicle;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,7 +28,7 @@ class GC_Turret : public GC_RigidBodyStatic
 	virtual PropertySet* NewPropertySet();
 
 protected:
-	static JobManager<GC_Turret> _jobManager;
+	int _jobTicket; // valid in TS_WAITING and TS_HIDDEN states
 
 	ObjPtr<GC_Sound>       _rotateSound;
 	ObjPtr<GC_Vehicle>     _target;
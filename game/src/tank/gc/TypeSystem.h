@@ -29,6 +29,8 @@ class RTTypes
 	template<class T> static GC_Object* FromFileCtor() { return new T(::FromFile()); }
 
 public:
+	typedef void (*TimeStepBatch) (GC_Object *const *objects, size_t count, float dt);
+
 	// access to singleton instance
 	static RTTypes& Inst()
 	{
@@ -57,7 +59,7 @@ public:
 		ei.offset  = offset;
 		ei.service = false;
 		ei.Create  = ActorCtor<T>;
-		_t2i[T::GetTypeStatic()] = ei;
+		AddTypeInfo(T::GetTypeStatic(), ei);
 		_n2t[name] = T::GetTypeStatic();
 		_i2t.push_back(T::GetTypeStatic());
 	}
@@ -71,7 +73,7 @@ public:
 		ei.name    = name;
 		ei.service = true;
 		ei.Create  = ServiceCtor<T>;
-		_t2i[T::GetTypeStatic()] = ei;
+		AddTypeInfo(T::GetTypeStatic(), ei);
 		_n2t[name] = T::GetTypeStatic();
 		_i2t.push_back(T::GetTypeStatic());
 	}
@@ -86,6 +88,9 @@ public:
 		// for serialization
 		assert(!_ffm.count(type));
 		_ffm[type] = FromFileCtor<T>;
+		// for TimeStepManager
+		_timeStep.push_back(&T::__TimeStepBatch);
+		assert(_timeStep.size() == _types.size());
 		return type;
 	}
 
@@ -100,11 +105,12 @@ public:
 	}
 	const EdItem& GetTypeInfoByIndex(int typeIndex)
 	{
-		return _t2i[_i2t[typeIndex]];
+		return *_typeInfo[_i2t[typeIndex]];
 	}
 	const EdItem& GetTypeInfo(ObjectType type)
 	{
-		return _t2i[type];
+		assert(IsRegistered(type));
+		return *_typeInfo[type];
 	}
 	ObjectType GetTypeByIndex(int typeIndex)
 	{
@@ -118,11 +124,15 @@ public:
 	const char* GetTypeName(ObjectType type)
 	{
 		assert(IsRegistered(type));
-		return _t2i[type].name;
+		return _typeInfo[type]->name;
 	}
 	bool IsRegistered(ObjectType type)
 	{
-		return _t2i.find(type) != _t2i.end();
+		return type >= 0 && type < (int) _typeInfo.size() && NULL != _typeInfo[type];
+	}
+	TimeStepBatch GetTimeStepBatch(ObjectType type)
+	{
+		return _timeStep[type];
 	}
 
 
@@ -137,12 +147,22 @@ public:
 private:
 	// for editor
 	type2item _t2i;
+	std::vector<const EdItem *> _typeInfo; // indexed by type; points into _t2i
 	name2type _n2t;
 	index2type _i2t; // sort by desc
 	// for serialization
 	FromFileMap _ffm;
+	// indexed by type
+	std::vector<TimeStepBatch> _timeStep;
 	// common
 	std::set<string_t> _types;
+	void AddTypeInfo(ObjectType type, const EdItem &ei)
+	{
+		if( (int) _typeInfo.size() <= type )
+			_typeInfo.resize(type + 1, NULL);
+		_typeInfo[type] = &(_t2i[type] = ei);
+	}
+
 	// use as singleton only
 	RTTypes() {};
 	static RTTypes *_theInstance;
@@ -65,15 +65,11 @@ void GC_UserObject::MapExchange(MapFile &f)
 	}
 }
 
-PropertySet* GC_UserObject::NewPropertySet()
-{
-	return new MyPropertySet(this);
-}
-
-GC_UserObject::MyPropertySet::MyPropertySet(GC_Object *object)
-  : BASE(object)
-  , _propTexture( ObjectProperty::TYPE_MULTISTRING, "texture" )
+// the property sets are cached by PropertyTable while textures may be
+// reloaded, so the list is refilled whenever a set is bound
+static void FillTextureList(ObjectProperty &prop)
 {
+	prop.ClearItems();
 	std::vector<string_t> names;
 	g_texman->GetTextureNames(names, NULL, false);
 	for( size_t i = 1; i < names.size(); ++i )
@@ -82,11 +78,23 @@ GC_UserObject::MyPropertySet::MyPropertySet(GC_Object *object)
 		if( lt.pxFrameWidth <= LOCATION_SIZE / 2 && lt.pxFrameHeight <= LOCATION_SIZE / 2 )
 		{
 			// only allow using textures which are less than half of cell
-			_propTexture.AddItem(names[i]);
+			prop.AddItem(names[i]);
 		}
 	}
 }
 
+PropertySet* GC_UserObject::NewPropertySet()
+{
+	return new MyPropertySet(this);
+}
+
+GC_UserObject::MyPropertySet::MyPropertySet(GC_Object *object)
+  : BASE(object)
+  , _propTexture( ObjectProperty::TYPE_MULTISTRING, "texture" )
+{
+	FillTextureList(_propTexture);
+}
+
 int GC_UserObject::MyPropertySet::GetCount() const
 {
 	return BASE::GetCount() + 1;
@@ -122,6 +130,7 @@ void GC_UserObject::MyPropertySet::MyExchange(bool applyToObject)
 	}
 	else
 	{
+		FillTextureList(_propTexture);
 		for( size_t i = 0; i < _propTexture.GetListSize(); ++i )
 		{
 			if( tmp->_textureName == _propTexture.GetListValue(i) )
@@ -220,17 +229,7 @@ GC_Decoration::MyPropertySet::MyPropertySet(GC_Object *object)
   , _propFrame(ObjectProperty::TYPE_INTEGER, "frame")
   , _propRotation(ObjectProperty::TYPE_FLOAT, "rotation")
 {
-	std::vector<string_t> names;
-	g_texman->GetTextureNames(names, NULL, false);
-	for( size_t i = 1; i < names.size(); ++i )
-	{
-		const LogicalTexture &lt = g_texman->Get(g_texman->FindSprite(names[i]));
-		if( lt.pxFrameWidth <= LOCATION_SIZE / 2 && lt.pxFrameHeight <= LOCATION_SIZE / 2 )
-		{
-			// only allow using textures which are less than half of cell
-			_propTexture.AddItem(names[i]);
-		}
-	}
+	FillTextureList(_propTexture);
 	_propLayer.SetIntRange(0, Z_COUNT-1);
 	_propAnimate.SetFloatRange(0, 100);
 	_propFrame.SetIntRange(0, 1000);
@@ -278,6 +277,7 @@ void GC_Decoration::MyPropertySet::MyExchange(bool applyToObject)
 	}
 	else
 	{
+		FillTextureList(_propTexture);
 		for( size_t i = 0; i < _propTexture.GetListSize(); ++i )
 		{
 			if( tmp->_textureName == _propTexture.GetListValue(i) )
@@ -20,6 +20,8 @@
 #include "turrets.h"
 #include "Weapons.h"
 
+#include "core/DetMath.h"
+
 #include "config/Config.h"
 #include "config/Language.h"
 
@@ -348,6 +350,7 @@ GC_Vehicle::GC_Vehicle(float x, float y)
 {
 	ZeroMemory(&_stateReal, sizeof(VehicleState));
 
+	AddContext(&g_level->grid_vehicles);
 	MoveTo(vec2d(x, y));
 
 	_visual = new GC_VehicleVisualDummy(this);
@@ -384,7 +387,7 @@ float GC_Vehicle::GetMaxBrakingLength() const
 	{
 		if( _Nx > 0 )
 		{
-			result = vx/_Mx - _Nx/(_Mx*_Mx)*(log(_Nx + _Mx*vx)-log(_Nx));
+			result = vx/_Mx - _Nx/(_Mx*_Mx)*(DetLog(_Nx + _Mx*vx)-DetLog(_Nx));
 		}
 		else
 		{
@@ -416,6 +419,9 @@ void GC_Vehicle::Serialize(SaveFile &f)
 	f.Serialize(_player);
 	f.Serialize(_weapon);
 	f.Serialize(_visual);
+
+	if( f.loading() )
+		AddContext(&g_level->grid_vehicles);
 }
 
 void GC_Vehicle::Kill()
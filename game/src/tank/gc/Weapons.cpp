@@ -286,6 +286,12 @@ void GC_Weapon::TimeStepFixed(float dt)
 	}
 }
 
+void GC_Weapon::OnWakeUp(float idleTime)
+{
+	_time += idleTime;
+	GC_Pickup::OnWakeUp(idleTime);
+}
+
 void GC_Weapon::TimeStepFloat(float dt)
 {
 	GC_Pickup::TimeStepFloat(dt);
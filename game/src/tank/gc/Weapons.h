@@ -86,6 +86,7 @@ public:
 
 	virtual void TimeStepFixed(float dt);
 	virtual void TimeStepFloat(float dt);
+	virtual void OnWakeUp(float idleTime);
 
 private:
 	virtual void OnUpdateView() {};
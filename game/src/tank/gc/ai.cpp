@@ -12,8 +12,8 @@
 #include "Weapons.h"
 #include "Camera.h"
 
-#include "core/JobManager.h"
 #include "core/Debug.h"
+#include "core/Profiler.h"
 
 #include "fs/SaveFile.h"
 #include "fs/MapFile.h"
@@ -22,6 +22,8 @@
 #include "Functions.h"
 #include "Level.h"
 
+PROFILE_TAG(tagThink, "AI think");
+
 ///////////////////////////////////////////////////////////////////////////////
 // Catmull-Rom interpolation
 
@@ -42,8 +44,6 @@ static void CatmullRom( const vec2d &p1, const vec2d &p2, const vec2d &p3, const
 
 ///////////////////////////////////////////////////////////////////////////////
 
-JobManager<GC_PlayerAI> GC_PlayerAI::_jobManager;
-
 IMPLEMENT_SELF_REGISTRATION(GC_PlayerAI)
 {
 	ED_SERVICE("ai", "obj_service_player_ai");
@@ -102,7 +102,7 @@ void GC_PlayerAI::Serialize(SaveFile &f)
 
 		if( GetVehicle() )
 		{
-			_jobManager.RegisterMember(this);
+			_jobTicket = g_level->jobs_ai.RegisterMember(this, AI_JOB_COST);
 		}
 	}
 	else
@@ -162,8 +162,12 @@ void GC_PlayerAI::TimeStepFixed(float dt)
 //	return;
 
 	// take decision
-	if( _jobManager.TakeJob(this) )
+	if( g_level->jobs_ai.TakeJob(_jobTicket, g_level->GetTime()) )
+	{
+		PROFILE_SCOPE(tagThink);
 		SelectState(&weapSettings);
+		g_level->jobs_ai.SetBoost(_jobTicket, NULL != PtrDynCast<GC_Vehicle>(_target));
+	}
 
 
 	// select a _currentOffset to reduce shooting accuracy
@@ -245,10 +249,10 @@ void GC_PlayerAI::TimeStepFixed(float dt)
 	}
 }
 
-bool GC_PlayerAI::CheckCell(const FieldCell &cell) const
+bool GC_PlayerAI::CheckCell(unsigned char passability) const
 {
-	if( (0xFF != cell.Properties() && GetVehicle()->GetWeapon()) ||
-		(0 == cell.Properties() && !GetVehicle()->GetWeapon()) )
+	if( (0xFF != passability && GetVehicle()->GetWeapon()) ||
+		(0 == passability && !GetVehicle()->GetWeapon()) )
 	{
 		return true;
 	}
@@ -262,35 +266,53 @@ float GC_PlayerAI::CreatePath(float dst_x, float dst_y, float max_depth, bool bT
 		return -1;
 	}
 
-	Field::NewSession();
 	Field &field = g_level->_field;
+	field.NewSession();
 
-	std::priority_queue<
-		RefFieldCell, std::vector<RefFieldCell>, std::greater<RefFieldCell>
-	> open;
+	struct OpenNode
+	{
+		float total;
+		int index;
+		bool operator > (const OpenNode &other) const { return total > other.total; }
+	};
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode> > open;
+
+	struct Estimate
+	{
+		static void Update(FieldNode &node, int x, int y, float before, int end_x, int end_y)
+		{
+			int dx = abs(end_x - x);
+			int dy = abs(end_y - y);
+			float pathAfter = (float) __max(dx, dy) + (float) __min(dx, dy) * 0.4142f;
+			node.before = before;
+			node.total = before + pathAfter;
+		}
+	};
 
 	int start_x = GRID_ALIGN(int(GetVehicle()->GetPos().x), CELL_SIZE);
 	int start_y = GRID_ALIGN(int(GetVehicle()->GetPos().y), CELL_SIZE);
 	int end_x = GRID_ALIGN(int(dst_x), CELL_SIZE);
 	int end_y = GRID_ALIGN(int(dst_y), CELL_SIZE);
 
-	FieldCell &start = field(start_x, start_y);
+	if( !CheckCell(field.GetPassability(start_x, start_y)) ) return -1;
 
-	if( !CheckCell(start) ) return -1;
+	int start = field.GetNodeIndex(start_x, start_y);
+	field.Check(start);
+	Estimate::Update(field.GetNode(start), start_x, start_y, 0, end_x, end_y);
+	field.GetNode(start).prev = -1;
 
-	start.Check();
-	start.UpdatePath(0, end_x, end_y);
-	start._prevCell  = NULL;
-
-	open.push( RefFieldCell(start) );
+	OpenNode on = { field.GetNode(start).total, start };
+	open.push(on);
 
 
 	while( !open.empty() )
 	{
-		FieldCell &cn = open.top();
+		int cn = open.top().index;
+		int cn_x = field.GetNodeX(cn);
+		int cn_y = field.GetNodeY(cn);
 		open.pop();
 
-		if( cn.GetX() == end_x && cn.GetY() == end_y )
+		if( cn_x == end_x && cn_y == end_y )
 			break; // a path was found
 
 
@@ -314,53 +336,62 @@ float GC_PlayerAI::CreatePath(float dst_x, float dst_y, float max_depth, bool bT
 		for( int i = 0; i < 8; ++i )
 		{
 			if( i > 3 ) // check diagonal passability
-			if( !CheckCell(field(cn.GetX() + per_x[check_diag[(i-4)*2  ]],
-			                     cn.GetY() + per_y[check_diag[(i-4)*2  ]])) ||
-			    !CheckCell(field(cn.GetX() + per_x[check_diag[(i-4)*2+1]],
-			                     cn.GetY() + per_y[check_diag[(i-4)*2+1]])) )
+			if( !CheckCell(field.GetPassability(cn_x + per_x[check_diag[(i-4)*2  ]],
+			                                    cn_y + per_y[check_diag[(i-4)*2  ]])) ||
+			    !CheckCell(field.GetPassability(cn_x + per_x[check_diag[(i-4)*2+1]],
+			                                    cn_y + per_y[check_diag[(i-4)*2+1]])) )
 			{
 				continue;
 			}
 
 
-			FieldCell &next = field(cn.GetX() + per_x[i], cn.GetY() + per_y[i]);
-			if( CheckCell(next) )
+			int next_x = cn_x + per_x[i];
+			int next_y = cn_y + per_y[i];
+			unsigned char passability = field.GetPassability(next_x, next_y);
+			if( CheckCell(passability) )
 			{
 				// increase path cost when travel through the walls
 				float dist_mult = 1;
-				if( 1 == next.Properties() )
+				if( 1 == passability )
 					dist_mult = ws->fDistanceMultipler;
 
-				if( !next.IsChecked() )
+				int next = field.GetNodeIndex(next_x, next_y);
+				if( !field.IsChecked(next) )
 				{
-					next._prevCell  = &cn;
-					next.UpdatePath(cn.Before() + dist[i] * dist_mult, end_x, end_y);
-					next.Check();
+					FieldNode &node = field.GetNode(next);
+					node.prev = cn;
+					Estimate::Update(node, next_x, next_y,
+						field.GetNode(cn).before + dist[i] * dist_mult, end_x, end_y);
+					field.Check(next);
 					//-----------------
-					if( next.Total() < max_depth )
-						open.push(RefFieldCell(next));
+					if( node.total < max_depth )
+					{
+						OpenNode on = { node.total, next };
+						open.push(on);
+					}
 				}
 
 				// next part of code causes assertions in <algorithm> because
 				// it can modify cells that are being stored in "open" queue
 
-				//else if( next._before > cn._before + dist[i] * dist_mult )
+				//else if( node.before > field.GetNode(cn).before + dist[i] * dist_mult )
 				//{
-				//	next._before = cn._before + dist[i] * dist_mult;
-				//	next._prevCell  = &cn;
+				//	node.before = field.GetNode(cn).before + dist[i] * dist_mult;
+				//	node.prev = cn;
 				//	//-----------------
-				//	if( next.Total() < max_depth )
-				//		open.push(RefFieldCell(next));
+				//	if( node.total < max_depth )
+				//		open.push(...);
 				//}
 			}
 		}
 	}
 
-	if( field(end_x, end_y).IsChecked() )
+	if( end_x >= 0 && end_x < field.GetX() && end_y >= 0 && end_y < field.GetY()
+		&& field.IsChecked(field.GetNodeIndex(end_x, end_y)) )
 	{
 		// a path was found
-		const FieldCell *cell = &field(end_x, end_y);
-		float distance = cell->Before();
+		int node = field.GetNodeIndex(end_x, end_y);
+		float distance = field.GetNode(node).before;
 
 		if( !bTest )
 		{
@@ -370,24 +401,27 @@ float GC_PlayerAI::CreatePath(float dst_x, float dst_y, float max_depth, bool bT
 
 			ClearPath();
 
-			PathNode node;
+			PathNode pathNode;
 
-			node.coord.x = dst_x; node.coord.y = dst_y;
-			_path.push_front(node);
+			pathNode.coord.x = dst_x; pathNode.coord.y = dst_y;
+			_path.push_front(pathNode);
 
-			cell = cell->_prevCell;
-			while( NULL != cell )
+			node = field.GetNode(node).prev;
+			while( -1 != node )
 			{
-				node.coord.x = (float) (cell->GetX() * CELL_SIZE);
-				node.coord.y = (float) (cell->GetY() * CELL_SIZE);
-				_path.push_front(node);
-
-				for( int i = 0; i < cell->GetObjectsCount(); ++i )
+				int x = field.GetNodeX(node);
+				int y = field.GetNodeY(node);
+				pathNode.coord.x = (float) (x * CELL_SIZE);
+				pathNode.coord.y = (float) (y * CELL_SIZE);
+				_path.push_front(pathNode);
+
+				const FieldCell &cell = field.GetCell(x, y);
+				for( int i = 0; i < cell.GetObjectsCount(); ++i )
 				{
 					assert(GetVehicle()->GetWeapon());
-					assert(cell->Properties() > 0);
+					assert(field.GetPassability(x, y) > 0);
 
-					GC_RigidBodyStatic *object = cell->GetObject(i);
+					GC_RigidBodyStatic *object = cell.GetObject(i);
 
 					//
 					// this piece of code protects friendly turrets.
@@ -404,7 +438,7 @@ float GC_PlayerAI::CreatePath(float dst_x, float dst_y, float max_depth, bool bT
 					_attackList.push_front(object);
 				}
 
-				cell = cell->_prevCell;
+				node = field.GetNode(node).prev;
 			}
 		}
 
@@ -659,8 +693,12 @@ bool GC_PlayerAI::FindTarget(/*out*/ AIITEMINFO &info, const AIWEAPSETTINGS *ws)
 	// check targets
 	//
 
-	FOREACH( g_level->GetList(LIST_vehicles), GC_Vehicle, object )
+	std::vector<GC_Vehicle*> candidates;
+	g_level->QueryVehicles(GetVehicle()->GetPos(), AI_MAX_SIGHT * CELL_SIZE, candidates);
+
+	for( size_t i = 0; i < candidates.size(); ++i )
 	{
+		GC_Vehicle *object = candidates[i];
 		if( !object->GetOwner() ||
 			(0 != object->GetOwner()->GetTeam() && object->GetOwner()->GetTeam() == GetTeam()) )
 		{
@@ -669,19 +707,15 @@ bool GC_PlayerAI::FindTarget(/*out*/ AIITEMINFO &info, const AIWEAPSETTINGS *ws)
 
 		if( object != GetVehicle() )
 		{
-			if( (GetVehicle()->GetPos() - object->GetPos()).sqr() <
-				(AI_MAX_SIGHT * CELL_SIZE) * (AI_MAX_SIGHT * CELL_SIZE) )
-			{
-				GC_RigidBodyStatic *pObstacle = static_cast<GC_RigidBodyStatic*>(
-					g_level->TraceNearest(g_level->grid_rigid_s, GetVehicle(),
-					GetVehicle()->GetPos(), object->GetPos() - GetVehicle()->GetPos()) );
+			GC_RigidBodyStatic *pObstacle = static_cast<GC_RigidBodyStatic*>(
+				g_level->TraceNearest(g_level->grid_rigid_s, GetVehicle(),
+				GetVehicle()->GetPos(), object->GetPos() - GetVehicle()->GetPos()) );
 
-				TargetDesc td;
-				td.target = object;
-				td.bIsVisible = (NULL == pObstacle || pObstacle == object);
+			TargetDesc td;
+			td.target = object;
+			td.bIsVisible = (NULL == pObstacle || pObstacle == object);
 
-				targets.push_back(td);
-			}
+			targets.push_back(td);
 		}
 	}
 
@@ -1325,7 +1359,7 @@ bool GC_PlayerAI::IsTargetVisible(GC_RigidBodyStatic *target, GC_RigidBodyStatic
 void GC_PlayerAI::OnRespawn()
 {
 	_arrivalPoint = GetVehicle()->GetPos();
-	_jobManager.RegisterMember(this);
+	_jobTicket = g_level->jobs_ai.RegisterMember(this, AI_JOB_COST);
 	SelectFavoriteWeapon();
 }
 
@@ -1335,7 +1369,7 @@ void GC_PlayerAI::OnDie()
 	_target = NULL;
 	ClearPath();
 
-	_jobManager.UnregisterMember(this);
+	g_level->jobs_ai.UnregisterMember(_jobTicket);
 }
 
 ////////////////////////////////////////////
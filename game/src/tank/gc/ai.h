@@ -7,10 +7,8 @@
 #include "Player.h"
 
 // forward declarations
-template<class> class JobManager;
 struct VehicleState;
 struct AIWEAPSETTINGS;
-class FieldCell;
 class GC_Actor;
 class GC_RigidBodyStatic;
 class GC_Pickup;
@@ -28,7 +26,7 @@ class GC_PlayerAI : public GC_Player
 {
 	DECLARE_SELF_REGISTRATION(GC_PlayerAI);
 
-	static JobManager<GC_PlayerAI> _jobManager;
+	int _jobTicket; // valid while the vehicle is alive
 
 	typedef std::list<ObjPtr<GC_RigidBodyStatic> > AttackListType;
 
@@ -81,7 +79,7 @@ protected:
 	std::list<PathNode>::const_iterator FindNearPathNode(const vec2d &pos, vec2d *proj, float *offset) const;
 
 	// check the cell's passability taking into account current weapon settings
-	bool CheckCell(const FieldCell &cell) const;
+	bool CheckCell(unsigned char passability) const;
 
 	struct TargetDesc
 	{
@@ -55,5 +55,17 @@ void GC_Crate::OnDestroy()
 	GC_RigidBodyDynamic::OnDestroy();
 }
 
+void GC_Crate::TimeStepFixed(float dt)
+{
+	GC_RigidBodyDynamic::TimeStepFixed(dt);
+
+	// a crate at rest has nothing to do until something pushes it;
+	// contacts and explosions wake it up through impulses
+	if( 0 == _lv.x && 0 == _lv.y && 0 == _av )
+	{
+		Sleep();
+	}
+}
+
 
 // end of file
@@ -13,6 +13,7 @@ public:
 	~GC_Crate();
 
 	virtual void OnDestroy();
+	virtual void TimeStepFixed(float dt);
 
 	virtual float GetDefaultHealth() const { return 50; }
 	virtual unsigned char GetPassability() const { return 0; }
@@ -22,6 +22,8 @@ enum NotifyType
 
 	// GC_Vehicle
 	NOTIFY_DAMAGE_FILTER,
+
+	NOTIFY_COUNT
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,15 +82,13 @@ void GC_Pickup::Serialize(SaveFile &f)
 
 GC_Actor* GC_Pickup::FindNewOwner() const
 {
-	float r_sq = GetRadius() * GetRadius();
+	std::vector<GC_Vehicle*> candidates;
+	g_level->QueryVehicles(GetPos(), GetRadius(), candidates);
 
-	FOREACH( g_level->GetList(LIST_vehicles), GC_Vehicle, veh )
+	for( size_t i = 0; i < candidates.size(); ++i )
 	{
-		if( (GetPos() - veh->GetPos()).sqr() < r_sq )
-		{
-			if( GetAutoSwitch() || veh->_stateReal._bState_AllowDrop )
-				return veh;
-		}
+		if( GetAutoSwitch() || candidates[i]->_stateReal._bState_AllowDrop )
+			return candidates[i];
 	}
 
 	return NULL;
@@ -152,6 +150,7 @@ bool GC_Pickup::Disappear()
 
 void GC_Pickup::SetRespawnTime(float respawnTime)
 {
+	WakeUp(); // to set a new alarm
 	_timeRespawn = respawnTime;
 }
 
@@ -227,12 +226,21 @@ void GC_Pickup::TimeStepFixed(float dt)
 		{
 			if( _timeAttached > _timeRespawn )  // FIXME
 				Respawn();
+			else
+				Sleep(_timeRespawn - _timeAttached);
 		}
 	}
 
 	GC_2dSprite::TimeStepFixed(dt);
 }
 
+void GC_Pickup::OnWakeUp(float idleTime)
+{
+	_timeAttached += idleTime;
+	_timeAnimation += idleTime;
+	GC_2dSprite::OnWakeUp(idleTime);
+}
+
 void GC_Pickup::Draw() const
 {
 	if( !GetBlinking() || fmod(_timeAnimation, 0.16f) > 0.08f || g_level->GetEditorMode() )
@@ -300,6 +308,7 @@ void GC_Pickup::MyPropertySet::MyExchange(bool applyToObject)
 	GC_Pickup *obj = static_cast<GC_Pickup*>(GetObject());
 	if( applyToObject )
 	{
+		obj->WakeUp();
 		obj->_timeRespawn = (float) _propTimeRespawn.GetIntValue() / 1000.0f;
 		obj->_scriptOnPickup = _propOnPickup.GetStringValue();
 	}
@@ -590,33 +599,26 @@ GC_Vehicle* GC_pu_Shock::FindNearVehicle(const GC_RigidBodyStatic *ignore)
 	// find the nearest enemy
 	//
 
-	float min_dist = AI_MAX_SIGHT * CELL_SIZE;
-	float dist;
+	std::vector<GC_Vehicle*> candidates;
+	g_level->QueryVehicles(GetPos(), AI_MAX_SIGHT * CELL_SIZE, candidates);
 
-	GC_Vehicle *pNearTarget = NULL;
-	FOREACH( g_level->GetList(LIST_vehicles), GC_Vehicle, pTargetObj )
+	for( size_t i = 0; i < candidates.size(); ++i )
 	{
+		GC_Vehicle *pTargetObj = candidates[i];
 		if( pTargetObj != ignore )
 		{
-			// distance to the object
-			dist = (GetPos() - pTargetObj->GetPos()).len();
+			GC_RigidBodyStatic *pObstacle = g_level->TraceNearest(g_level->grid_rigid_s,
+				static_cast<GC_RigidBodyStatic*>(GetCarrier()),
+				GetPos(), pTargetObj->GetPos() - GetPos());
 
-			if( dist < min_dist )
+			if( pObstacle == pTargetObj )
 			{
-				GC_RigidBodyStatic *pObstacle = g_level->TraceNearest(g_level->grid_rigid_s,
-					static_cast<GC_RigidBodyStatic*>(GetCarrier()),
-					GetPos(), pTargetObj->GetPos() - GetPos());
-
-				if( pObstacle == pTargetObj )
-				{
-					pNearTarget = pTargetObj;
-					min_dist = dist;
-				}
+				return pTargetObj; // the nearest visible one
 			}
 		}
 	}
 
-	return pNearTarget;
+	return NULL;
 }
 
 void GC_pu_Shock::TimeStepFixed(float dt)
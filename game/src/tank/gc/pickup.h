@@ -57,6 +57,7 @@ protected:
 
 	virtual void TimeStepFixed(float dt);
 	virtual void TimeStepFloat(float dt);
+	virtual void OnWakeUp(float idleTime);
 	virtual void Kill();
 
 	virtual void Draw() const;
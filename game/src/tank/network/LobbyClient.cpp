@@ -33,18 +33,57 @@ static std::string GenerateKey(unsigned int length)
 	return result;
 }
 
-static bool ParseServerList(std::vector<std::string> &result, const std::string &data)
+// the lobby sends changes since the generation the client has seen:
+//   gen <generation>
+//   full             (optional; the list starts from scratch)
+//   + <address>
+//   - <address>
+//   end
+// nothing is applied unless the reply is complete
+static bool ParseServerList(std::set<std::string> &servers, std::string &generation, const std::string &data)
 {
 	std::istringstream in(data);
 
 	std::string s;
+	if( !std::getline(in, s) || 0 != s.compare(0, 4, "gen ") )
+	{
+		return false;
+	}
+	std::string newGeneration = s.substr(4);
+
+	bool full = false;
+	std::vector<std::string> changes;
 	while( std::getline(in, s) )
 	{
 		if( s == "end" )
 		{
+			if( full )
+			{
+				servers.clear();
+			}
+			for( size_t i = 0; i < changes.size(); ++i )
+			{
+				if( '+' == changes[i][0] )
+					servers.insert(changes[i].substr(2));
+				else
+					servers.erase(changes[i].substr(2));
+			}
+			generation = newGeneration;
 			return true;
 		}
-		result.push_back(s);
+		if( s == "full" )
+		{
+			full = true;
+			changes.clear();
+		}
+		else if( s.size() > 2 && ('+' == s[0] || '-' == s[0]) && ' ' == s[1] )
+		{
+			changes.push_back(s);
+		}
+		else
+		{
+			return false;
+		}
 	}
 	return false;
 }
@@ -82,7 +121,12 @@ void LobbyClient::ResetHttp()
 void LobbyClient::SetLobbyUrl(const std::string &lobbyUrl)
 {
 	assert(STATE_IDLE == _state);
-	_lobbyUrl = lobbyUrl;
+	if( _lobbyUrl != lobbyUrl )
+	{
+		_lobbyUrl = lobbyUrl;
+		_generation.clear();
+		_servers.clear();
+	}
 }
 
 void LobbyClient::RequestServerList()
@@ -92,6 +136,7 @@ void LobbyClient::RequestServerList()
 	_redirectCount = 0;
 	_param.clear();
 	_param["ver"] = LOBBY_VERSION;
+	_param["gen"] = _generation.empty() ? "0" : _generation;
 
 	ResetHttp();
 	_http->Get(_lobbyUrl, _param);
@@ -188,11 +233,11 @@ void LobbyClient::OnHttpResult(int err, const std::string &result, const HttpPar
 				case STATE_LIST:
 				{
 					_state = STATE_IDLE;
-					std::vector<std::string> svlist;
-					if( ParseServerList(svlist, result) )
+					if( ParseServerList(_servers, _generation, result) )
 					{
 						if( eventServerListReply )
 						{
+							std::vector<std::string> svlist(_servers.begin(), _servers.end());
 							INVOKE(eventServerListReply) (svlist);
 						}
 					}
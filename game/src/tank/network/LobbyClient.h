@@ -35,6 +35,8 @@ private:
 	SafePtr<HttpClient> _http;
 	std::string _sessionKey;
 	std::string _lobbyUrl;
+	std::string _generation;         // of _servers as reported by the lobby
+	std::set<std::string> _servers;  // updated with changes since _generation
 	int _redirectCount;
 	HANDLE _timer;
 	State _state;
@@ -0,0 +1,117 @@
+// LoopbackLink.cpp
+
+#include "stdafx.h"
+#include "LoopbackLink.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const size_t SEGMENT_SIZE = 1460; // typical tcp mss
+static const double MIN_RTO      = 0.2;  // minimum retransmit timeout, seconds
+
+LinkSettings::LinkSettings()
+  : latency(0)
+  , jitter(0)
+  , loss(0)
+  , bandwidth(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+LoopbackLink::LoopbackLink(const LinkSettings &settings, unsigned long seed)
+  : _settings(settings)
+  , _now(0)
+  , _busyUntil(0)
+  , _lastArrival(0)
+  , _seed(seed)
+  , _bytesSent(0)
+  , _bytesDelivered(0)
+  , _retransmits(0)
+{
+	assert(_settings.loss >= 0 && _settings.loss < 1);
+}
+
+LoopbackLink::~LoopbackLink()
+{
+}
+
+float LoopbackLink::Rand01()
+{
+	// own generator keeps the simulation independent from rand() and net_rand()
+	_seed = _seed * 214013 + 2531011;
+	return (float) ((_seed >> 16) & 0x7fff) / 32768.0f;
+}
+
+void LoopbackLink::Write(const void *data, size_t size)
+{
+	const char *src = (const char *) data;
+	_bytesSent += size;
+
+	while( size )
+	{
+		size_t chunk = std::min(size, SEGMENT_SIZE);
+
+		double departure = std::max(_now, _busyUntil);
+		if( _settings.bandwidth )
+		{
+			departure += (double) chunk / (double) _settings.bandwidth;
+		}
+		_busyUntil = departure;
+
+		double arrival = departure + _settings.latency + _settings.jitter * Rand01();
+
+		// each loss costs one retransmit timeout
+		double rto = std::max(MIN_RTO, 2.0 * (_settings.latency + _settings.jitter));
+		while( Rand01() < _settings.loss )
+		{
+			arrival += rto;
+			++_retransmits;
+		}
+
+		// tcp never reorders the stream
+		arrival = std::max(arrival, _lastArrival);
+		_lastArrival = arrival;
+
+		_inFlight.push_back(Segment());
+		_inFlight.back().arrival = arrival;
+		_inFlight.back().data.assign(src, src + chunk);
+
+		src += chunk;
+		size -= chunk;
+	}
+}
+
+size_t LoopbackLink::Read(void *dst, size_t size)
+{
+	size_t count = std::min(size, _received.size());
+	if( count )
+	{
+		memcpy(dst, &_received[0], count);
+		_received.erase(_received.begin(), _received.begin() + count);
+	}
+	return count;
+}
+
+void LoopbackLink::Update(double now)
+{
+	assert(now >= _now);
+	_now = now;
+
+	bool delivered = false;
+	while( !_inFlight.empty() && _inFlight.front().arrival <= _now )
+	{
+		const std::vector<char> &data = _inFlight.front().data;
+		_received.insert(_received.end(), data.begin(), data.end());
+		_bytesDelivered += data.size();
+		_inFlight.pop_front();
+		delivered = true;
+	}
+
+	if( delivered && eventReceive )
+	{
+		INVOKE(eventReceive) ();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -0,0 +1,67 @@
+// LoopbackLink.h
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// in-process replacement for one direction of a tcp connection.
+// bytes are split into segments which are delivered in order after the
+// simulated latency; lost segments are delivered after retransmit timeout.
+
+struct LinkSettings
+{
+	float  latency;    // one-way delay, seconds
+	float  jitter;     // maximum extra random delay, seconds
+	float  loss;       // probability of a segment to be lost, [0..1)
+	size_t bandwidth;  // bytes per second; 0 - unlimited
+
+	LinkSettings();
+};
+
+class LoopbackLink : public RefCounted
+{
+public:
+	LoopbackLink(const LinkSettings &settings, unsigned long seed);
+	virtual ~LoopbackLink();
+
+	// sender side
+	void Write(const void *data, size_t size);
+
+	// receiver side
+	size_t GetAvailable() const { return _received.size(); }
+	size_t Read(void *dst, size_t size);
+	Delegate<void()> eventReceive;
+
+	// moves arrived segments to the receive buffer and fires eventReceive
+	void Update(double now);
+
+	size_t GetBytesSent() const { return _bytesSent; }
+	size_t GetBytesDelivered() const { return _bytesDelivered; }
+	size_t GetRetransmits() const { return _retransmits; }
+	size_t GetInFlight() const { return _bytesSent - _bytesDelivered; }
+
+private:
+	struct Segment
+	{
+		double arrival;
+		std::vector<char> data;
+	};
+
+	float Rand01();
+
+	LinkSettings _settings;
+	std::deque<Segment> _inFlight;
+	std::vector<char> _received;
+
+	double _now;
+	double _busyUntil;    // the moment the last segment leaves the sender
+	double _lastArrival;  // keeps delivery order
+
+	unsigned long _seed;
+
+	size_t _bytesSent;
+	size_t _bytesDelivered;
+	size_t _retransmits;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
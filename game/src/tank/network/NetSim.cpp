@@ -0,0 +1,480 @@
+// NetSim.cpp
+
+#include "stdafx.h"
+#include "NetSim.h"
+#include "Peer.h"
+#include "TankServer.h"
+#include "ClientFunctions.h"
+#include "ServerFunctions.h"
+#include "CommonTypes.h"
+
+#include "core/debug.h"
+#include "core/DetMath.h"
+
+#include "config/Config.h"
+
+#include "fs/FileSystem.h"
+
+#include "gc/indicators.h"
+#include "Level.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const unsigned int INPUT_HOLD_FRAMES = 30; // how long a scripted input stays unchanged
+static const float JOIN_TIMEOUT = 10;             // seconds of virtual time
+static const int ARENA_WIDTH = 24;                // cells; spawn points go in rows of eight
+static const unsigned long DETTEST_SEED = 1;
+
+static DWORD HashCombine(DWORD hash, DWORD value)
+{
+	hash = hash ^ value ^ 0xD202EF8D;
+	return (hash >> 1) | ((hash & 0x00000001) << 31);
+}
+
+static DWORD HashCombine(DWORD hash, float value)
+{
+	return HashCombine(hash, reinterpret_cast<const DWORD&>(value));
+}
+
+// the same in every build, so that the determinism test can reuse it
+static ControlPacket GetScriptedInput(size_t player, unsigned int frame)
+{
+	DWORD h = HashCombine(HashCombine(0, (DWORD) player + 1), (DWORD) (frame / INPUT_HOLD_FRAMES));
+	h *= 2654435761U; // spread the bits
+
+	ControlPacket cp;
+	cp.wControlState = (WORD) (h & (STATE_MOVEFORWARD | STATE_MOVEBACK | STATE_ROTATELEFT |
+		STATE_ROTATERIGHT | STATE_FIRE | STATE_TOWERLEFT | STATE_TOWERRIGHT));
+	return cp;
+}
+
+static void Replay(size_t playerCount, unsigned long seed, const std::vector<ControlPacketVector> &frames,
+                   unsigned int frameCount, std::vector<DWORD> &hashes)
+{
+	try
+	{
+		int rows = (int) (playerCount + 7) / 8;
+		g_level->init_emptymap(ARENA_WIDTH, rows * 3 + 2);
+		g_level->_seed = seed;
+
+		// every replay builds the same arena and adds players in the same
+		// order, so only the frames may differ
+		for( size_t i = 0; i < playerCount; ++i )
+		{
+			new GC_SpawnPoint((float) ((i % 8) * 3 + 1) * CELL_SIZE, (float) ((i / 8) * 3 + 1) * CELL_SIZE);
+		}
+		for( size_t i = 0; i < playerCount; ++i )
+		{
+			std::ostringstream nick;
+			nick << "sim" << i;
+			PlayerDesc pd;
+			pd.nick = nick.str();
+			pd.cls = "default";
+			pd.team = 0;
+			g_level->AddHuman(pd);
+		}
+
+		float dt_fixed = 1.0f / g_conf.sv_fps.GetFloat();
+		hashes.clear();
+		for( unsigned int frame = 0; frame < frameCount; ++frame )
+		{
+			g_level->Step(frames[frame], dt_fixed);
+			hashes.push_back(g_level->GetStateHash());
+		}
+	}
+	catch( ... )
+	{
+		g_level->Clear();
+		throw;
+	}
+	g_level->Clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NetSimClient::NetSimClient(size_t index, size_t playerCount,
+                           const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut)
+  : _linkIn(linkIn)
+  , _linkOut(linkOut)
+  , _hasCtrl(false)
+  , _index(index)
+  , _playerCount(playerCount)
+  , _playersKnown(0)
+  , _frame(0)
+  , _ctrlSent(0)
+  , _maxBehind(0)
+  , _timeBuffer(0)
+  , _stallTime(0)
+{
+	_peer = new Peer(linkIn, linkOut);
+	_peer->eventDisconnect.bind(&NetSimClient::OnDisconnect, this);
+
+	_peer->RegisterHandler<std::string>(CL_POST_TEXTMESSAGE, CreateDelegate(&NetSimClient::ClIgnore, this));
+	_peer->RegisterHandler<GameInfo>(CL_POST_GAMEINFO, CreateDelegate(&NetSimClient::ClGameInfo, this));
+	_peer->RegisterHandler<unsigned short>(CL_POST_PLAYERQUIT, CreateDelegate(&NetSimClient::ClIgnore, this));
+	_peer->RegisterHandler<ControlPacketVector>(CL_POST_CONTROL, CreateDelegate(&NetSimClient::ClControl, this));
+	_peer->RegisterHandler<PlayerDescEx>(CL_POST_PLAYERINFO, CreateDelegate(&NetSimClient::ClPlayerInfo, this));
+	_peer->RegisterHandler<float>(CL_POST_SETBOOST, CreateDelegate(&NetSimClient::ClIgnore, this));
+}
+
+NetSimClient::~NetSimClient()
+{
+	if( _peer )
+	{
+		_peer->Close();
+		_peer = NULL;
+	}
+}
+
+size_t NetSimClient::GetTrafficIn() const
+{
+	return _linkIn->GetBytesDelivered();
+}
+
+size_t NetSimClient::GetTrafficOut() const
+{
+	return _linkOut->GetBytesSent();
+}
+
+void NetSimClient::Apply(const ControlPacketVector &ctrl)
+{
+	_received.push_back(ctrl);
+	++_frame;
+}
+
+void NetSimClient::UpdateMaxBehind(unsigned int leaderFrame)
+{
+	_maxBehind = std::max(_maxBehind, (int) (leaderFrame - _frame));
+}
+
+void NetSimClient::Tick(float dt, float dt_fixed)
+{
+	// same buffering scheme as the main loop, but the number of control packets
+	// in flight is limited by cl_latency instead of spinning while stalled
+	float bufmax = (g_conf.cl_latency.GetFloat() + 1) * dt_fixed;
+	_timeBuffer = std::min(_timeBuffer + dt, bufmax);
+
+	if( _timeBuffer + dt_fixed / 2 > 0 )
+	{
+		do
+		{
+			if( _ctrlSent - _frame <= (unsigned int) g_conf.cl_latency.GetInt() )
+			{
+				_peer->Post(SV_POST_CONTROL, Variant(GetScriptedInput(_index, _ctrlSent)));
+				++_ctrlSent;
+			}
+
+			if( !_hasCtrl )
+			{
+				_peer->Resume();
+			}
+			if( !_hasCtrl )
+			{
+				_stallTime += dt;
+				break;
+			}
+
+			_hasCtrl = false;
+			_timeBuffer -= dt_fixed;
+			Apply(_ctrl);
+		} while( _timeBuffer > 0 );
+	}
+}
+
+void NetSimClient::ClGameInfo(Peer *from, int task, const Variant &arg)
+{
+	PlayerDesc pd;
+	std::ostringstream nick;
+	nick << "sim" << _index;
+	pd.nick = nick.str();
+	pd.cls = "default";
+	pd.team = 0;
+	_peer->Post(SV_POST_PLAYERINFO, Variant(pd));
+}
+
+void NetSimClient::ClPlayerInfo(Peer *from, int task, const Variant &arg)
+{
+	++_playersKnown;
+}
+
+void NetSimClient::ClControl(Peer *from, int task, const Variant &arg)
+{
+	assert(!_hasCtrl);
+	_ctrl = arg.Value<ControlPacketVector>();
+	_hasCtrl = true;
+	_peer->Pause();
+}
+
+void NetSimClient::ClIgnore(Peer *from, int task, const Variant &arg)
+{
+}
+
+void NetSimClient::OnDisconnect(Peer *from, int err)
+{
+	TRACE("netsim: client %u disconnected (%d)", _index, err);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NetSimulator::NetSimulator(size_t clientCount, const LinkSettings &settings, unsigned long seed)
+  : _seed(seed)
+  , _time(0)
+  , _gameStartTime(-1)
+  , _desyncFrame(-1)
+  , _desyncClient(0)
+{
+	GameInfo gi = {0};
+	gi.seed = seed;
+	gi.server_fps = (short) g_conf.sv_fps.GetInt();
+	strcpy(gi.cMapName, "netsim");
+
+	_server.reset(new TankServer(gi));
+
+	for( size_t i = 0; i < clientCount; ++i )
+	{
+		SafePtr<LoopbackLink> up(new LoopbackLink(settings, seed + i * 2));
+		SafePtr<LoopbackLink> down(new LoopbackLink(settings, seed + i * 2 + 1));
+		_links.push_back(up);
+		_links.push_back(down);
+
+		_clients.push_back(new NetSimClient(i, clientCount, down, up));
+		_server->Accept(up, down);
+	}
+}
+
+NetSimulator::~NetSimulator()
+{
+	for( size_t i = 0; i < _clients.size(); ++i )
+	{
+		delete _clients[i];
+	}
+	_server.reset();
+}
+
+void NetSimulator::UpdateLinks()
+{
+	for( size_t i = 0; i < _links.size(); ++i )
+	{
+		_links[i]->Update(_time);
+	}
+}
+
+bool NetSimulator::CheckSync()
+{
+	unsigned int common = -1;
+	for( size_t i = 0; i < _clients.size(); ++i )
+	{
+		common = std::min(common, _clients[i]->GetFrame());
+	}
+
+	std::vector<DWORD> reference;
+	Replay(_clients.size(), _seed, _clients[0]->GetReceived(), common, reference);
+
+	std::vector<DWORD> hashes;
+	for( size_t i = 1; i < _clients.size(); ++i )
+	{
+		Replay(_clients.size(), _seed, _clients[i]->GetReceived(), common, hashes);
+		for( unsigned int frame = 0; frame < common; ++frame )
+		{
+			if( hashes[frame] != reference[frame] )
+			{
+				if( frame < _desyncFrame )
+				{
+					_desyncFrame = frame;
+					_desyncClient = i;
+				}
+				break;
+			}
+		}
+	}
+	return -1 == _desyncFrame;
+}
+
+bool NetSimulator::Run(float duration)
+{
+	float dt_fixed = 1.0f / g_conf.sv_fps.GetFloat();
+
+	//
+	// join
+	//
+
+	for( ;; )
+	{
+		UpdateLinks();
+
+		bool joined = true;
+		for( size_t i = 0; i < _clients.size(); ++i )
+		{
+			joined &= _clients[i]->IsJoined();
+		}
+		if( joined )
+		{
+			break;
+		}
+		if( _time > JOIN_TIMEOUT )
+		{
+			TRACE("netsim: clients failed to join within %g seconds", JOIN_TIMEOUT);
+			return false;
+		}
+		_time += dt_fixed;
+	}
+
+	_gameStartTime = _time;
+
+
+	//
+	// play
+	//
+
+	while( _time < _gameStartTime + duration )
+	{
+		_time += dt_fixed;
+		UpdateLinks();
+
+		unsigned int leader = 0;
+		for( size_t i = 0; i < _clients.size(); ++i )
+		{
+			_clients[i]->Tick(dt_fixed, dt_fixed);
+			leader = std::max(leader, _clients[i]->GetFrame());
+		}
+		for( size_t i = 0; i < _clients.size(); ++i )
+		{
+			_clients[i]->UpdateMaxBehind(leader);
+		}
+	}
+
+	return CheckSync();
+}
+
+void NetSimulator::PrintReport() const
+{
+	float elapsed = (float) (_time - std::max(_gameStartTime, 0.0));
+	if( elapsed <= 0 )
+	{
+		return;
+	}
+
+	GetConsole().Printf(0, "netsim: %u clients, %.1f s, join took %.2f s, seed %lu",
+		(unsigned int) _clients.size(), elapsed, (float) std::max(_gameStartTime, 0.0), _seed);
+
+	for( size_t i = 0; i < _clients.size(); ++i )
+	{
+		const NetSimClient &cl = *_clients[i];
+		GetConsole().Printf(0, "  cl%u: frames %u, behind max %d, stall %.2f s, in %.0f B/s, out %.0f B/s, retransmits %u",
+			(unsigned int) i, cl.GetFrame(), cl.GetMaxBehind(), cl.GetStallTime(),
+			(float) cl.GetTrafficIn() / elapsed, (float) cl.GetTrafficOut() / elapsed,
+			_links[i*2]->GetRetransmits() + _links[i*2+1]->GetRetransmits());
+	}
+
+	if( -1 != _desyncFrame )
+	{
+		GetConsole().Printf(1, "netsim: level state of cl%u differs from cl0 at frame %u", (unsigned int) _desyncClient, _desyncFrame);
+	}
+	else
+	{
+		GetConsole().Printf(0, "netsim: all clients in sync");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static DWORD HashDetMath()
+{
+	DWORD hash = 0;
+	for( int i = 0; i < 1024; ++i )
+	{
+		hash = HashCombine(hash, DetExp((float) (i - 512) / 64));
+		hash = HashCombine(hash, DetLog((float) (i + 1) / 64));
+		hash = HashCombine(hash, DetSqrt((float) i / 16));
+	}
+	return hash;
+}
+
+bool RunDetTest(size_t playerCount, unsigned int frameCount, const string_t &refName)
+{
+	std::vector<ControlPacketVector> frames(frameCount, ControlPacketVector(playerCount));
+	for( unsigned int frame = 0; frame < frameCount; ++frame )
+	{
+		for( size_t i = 0; i < playerCount; ++i )
+		{
+			frames[frame][i] = GetScriptedInput(i, frame);
+		}
+	}
+
+	DWORD mathHash = HashDetMath();
+	std::vector<DWORD> hashes;
+	Replay(playerCount, DETTEST_SEED, frames, frameCount, hashes);
+
+	// a second match in the same process must not depend on the first one
+	std::vector<DWORD> hashes2;
+	Replay(playerCount, DETTEST_SEED, frames, frameCount, hashes2);
+	for( unsigned int frame = 0; frame < frameCount; ++frame )
+	{
+		if( hashes2[frame] != hashes[frame] )
+		{
+			GetConsole().Printf(1, "dettest: the second match differs from the first at frame %u", frame);
+			return false;
+		}
+	}
+
+	std::set<string_t> files;
+	g_fs->EnumAllFiles(files, refName);
+	if( files.empty() )
+	{
+		std::ostringstream out;
+		out << std::hex << playerCount << ' ' << mathHash << '\n';
+		for( size_t i = 0; i < hashes.size(); ++i )
+		{
+			out << hashes[i] << '\n';
+		}
+		string_t buf = out.str();
+		g_fs->Open(refName, FS::ModeWrite)->QueryStream()->Write(buf.data(), buf.size());
+		GetConsole().Printf(0, "dettest: %u frames written to the reference '%s'", frameCount, refName.c_str());
+		return true;
+	}
+
+	SafePtr<FS::MemMap> m = g_fs->Open(refName)->QueryMap();
+	std::istringstream in(string_t(m->GetData(), m->GetSize()));
+	in >> std::hex;
+
+	size_t refPlayerCount = 0;
+	DWORD refMathHash = 0;
+	in >> refPlayerCount >> refMathHash;
+	if( !in || refPlayerCount != playerCount )
+	{
+		throw std::runtime_error("the reference was recorded with a different number of players");
+	}
+
+	bool ok = true;
+	if( refMathHash != mathHash )
+	{
+		GetConsole().Printf(1, "dettest: DetMath results differ from the reference");
+		ok = false;
+	}
+
+	unsigned int frame = 0;
+	DWORD refHash;
+	for( ; frame < frameCount && in >> refHash; ++frame )
+	{
+		if( refHash != hashes[frame] )
+		{
+			GetConsole().Printf(1, "dettest: level state differs from the reference at frame %u", frame);
+			ok = false;
+			break;
+		}
+	}
+
+	if( ok && frame < frameCount )
+	{
+		GetConsole().Printf(1, "dettest: the reference '%s' has only %u of %u frames", refName.c_str(), frame, frameCount);
+		ok = false;
+	}
+	if( ok )
+	{
+		GetConsole().Printf(0, "dettest: %u frames match the reference '%s'", frame, refName.c_str());
+	}
+	return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
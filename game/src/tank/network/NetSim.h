@@ -0,0 +1,111 @@
+// NetSim.h
+
+#pragma once
+
+#include "LoopbackLink.h"
+#include "ControlPacket.h"
+
+class Peer;
+class TankServer;
+
+///////////////////////////////////////////////////////////////////////////////
+// headless client which speaks the same protocol as TankClient but only
+// records the frames it receives; the simulator replays them through the
+// Level afterwards
+
+class NetSimClient
+{
+public:
+	NetSimClient(size_t index, size_t playerCount,
+	             const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut);
+	~NetSimClient();
+
+	void Tick(float dt, float dt_fixed);
+
+	bool IsJoined() const { return _playersKnown >= _playerCount; }
+	unsigned int GetFrame() const { return _frame; }
+	const std::vector<ControlPacketVector>& GetReceived() const { return _received; }
+
+	float GetStallTime() const { return _stallTime; }
+	size_t GetTrafficIn() const;
+	size_t GetTrafficOut() const;
+
+	void UpdateMaxBehind(unsigned int leaderFrame);
+	int GetMaxBehind() const { return _maxBehind; }
+
+private:
+	void Apply(const ControlPacketVector &ctrl);
+
+	// remote functions
+	void ClGameInfo(Peer *from, int task, const Variant &arg);
+	void ClPlayerInfo(Peer *from, int task, const Variant &arg);
+	void ClControl(Peer *from, int task, const Variant &arg);
+	void ClIgnore(Peer *from, int task, const Variant &arg);
+	void OnDisconnect(Peer *from, int err);
+
+	SafePtr<Peer> _peer;
+	SafePtr<LoopbackLink> _linkIn;
+	SafePtr<LoopbackLink> _linkOut;
+
+	ControlPacketVector _ctrl;
+	bool _hasCtrl;
+
+	size_t _index;
+	size_t _playerCount;
+	size_t _playersKnown;
+
+	unsigned int _frame;
+	unsigned int _ctrlSent;
+	std::vector<ControlPacketVector> _received;
+	int _maxBehind;
+
+	float _timeBuffer;
+	float _stallTime;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// runs one server and several clients in the current process over lossy
+// loopback links using virtual time. then the frames each client received
+// are replayed one client at a time through g_level, which must be free,
+// and the state hashes of the replays are compared frame by frame
+
+class NetSimulator
+{
+public:
+	NetSimulator(size_t clientCount, const LinkSettings &settings, unsigned long seed);
+	~NetSimulator();
+
+	// returns false if clients failed to join or went out of sync;
+	// the level is cleared afterwards
+	bool Run(float duration);
+
+	void PrintReport() const;
+
+private:
+	std::unique_ptr<TankServer> _server;
+	std::vector<NetSimClient *> _clients;
+	std::vector<SafePtr<LoopbackLink> > _links;
+
+	unsigned long _seed;
+	double _time;
+	double _gameStartTime;
+	unsigned int _desyncFrame;
+	size_t _desyncClient;
+
+	void UpdateLinks();
+	bool CheckSync();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// cross-build regression: plays a fixed scenario with scripted inputs through
+// g_level, which must be free, without the network, twice in a row so that
+// state left over from the first match shows up. the state hashes of all
+// frames and a sample of DetMath results are compared with the reference
+// file. if there is none, it is written instead; create it with a known good
+// build and copy it next to the build under test. the level is cleared
+// afterwards. returns false if the matches or the reference disagree
+
+bool RunDetTest(size_t playerCount, unsigned int frameCount, const string_t &refName);
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -3,9 +3,13 @@
 #include "stdafx.h"
 
 #include "Peer.h"
+#include "LoopbackLink.h"
 
 #include "core/debug.h"
 #include "core/Application.h"
+#include "core/Profiler.h"
+
+PROFILE_TAG(tagInput, "Peer::ProcessInput");
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -13,6 +17,7 @@ Peer::Peer(SOCKET s)
   : _in(false)
   , _out(true)
   , _socket(s)
+  , _sentRecent(0)
   , _paused(false)
   , _readyToSend(true)
 {
@@ -24,13 +29,35 @@ Peer::Peer(SOCKET s)
 	_socket.SetCallback(CreateDelegate(&Peer::OnSocketEvent, this));
 }
 
+Peer::Peer(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut)
+  : _in(false)
+  , _out(true)
+  , _linkIn(linkIn)
+  , _linkOut(linkOut)
+  , _sentRecent(0)
+  , _paused(false)
+  , _readyToSend(true)
+{
+	assert(_linkIn && _linkOut);
+	assert(!_linkIn->eventReceive);
+	_linkIn->eventReceive.bind(&Peer::OnLinkEvent, this);
+}
+
 Peer::~Peer()
 {
 	assert(INVALID_SOCKET == _socket);
+	assert(!_linkIn && !_linkOut);
 }
 
 void Peer::Close()
 {
+	if( _linkIn )
+	{
+		_linkIn->eventReceive.clear();
+		_linkIn = NULL;
+		_linkOut = NULL;
+		return;
+	}
 	assert(INVALID_SOCKET != _socket);
 	_socket.Close();
 }
@@ -120,27 +147,9 @@ void Peer::OnSocketEvent()
 		}
 		else
 		{
-			while( _in.EntityProbe() )
+			if( !ParseInput() )
 			{
-				_pendingCalls.push(PendingRemoteCall());
-				PendingRemoteCall &pc = _pendingCalls.back();
-
-				_in.EntityBegin();
-				int func;
-				_in & func;
-				HandlersMap::const_iterator it = _handlers.find(func);
-				if( _handlers.end() == it )
-				{
-					_pendingCalls.pop();
-					TRACE("peer: invalid function code");
-					assert(eventDisconnect);
-					INVOKE(eventDisconnect) (this, 0);
-					return;
-				}
-				pc.handler = it->second.handler;
-				pc.arg.ChangeType(it->second.argType);
-				_in & pc.arg;
-				_in.EntityEnd();
+				return;
 			}
 
 			if( !_paused )
@@ -167,8 +176,54 @@ void Peer::OnSocketEvent()
 	}
 }
 
+void Peer::OnLinkEvent()
+{
+	assert(_linkIn);
+
+	if( _in.Recv(*_linkIn) > 0 )
+	{
+		if( !ParseInput() )
+		{
+			return;
+		}
+
+		if( !_paused )
+		{
+			ProcessInput();
+		}
+	}
+}
+
+bool Peer::ParseInput()
+{
+	while( _in.EntityProbe() )
+	{
+		_pendingCalls.push(PendingRemoteCall());
+		PendingRemoteCall &pc = _pendingCalls.back();
+
+		_in.EntityBegin();
+		int func;
+		_in & func;
+		HandlersMap::const_iterator it = _handlers.find(func);
+		if( _handlers.end() == it )
+		{
+			_pendingCalls.pop();
+			TRACE("peer: invalid function code");
+			assert(eventDisconnect);
+			INVOKE(eventDisconnect) (this, 0);
+			return false;
+		}
+		pc.handler = it->second.handler;
+		pc.arg.ChangeType(it->second.argType);
+		_in & pc.arg;
+		_in.EntityEnd();
+	}
+	return true;
+}
+
 void Peer::ProcessInput()
 {
+	PROFILE_SCOPE(tagInput);
 	while( !_pendingCalls.empty() )
 	{
 		if( _paused )
@@ -187,6 +242,12 @@ bool Peer::TrySend()
 {
 	assert(_readyToSend);
 	size_t sent;
+	if( _linkOut )
+	{
+		_out.Send(*_linkOut, &sent);
+		_sentRecent += sent;
+		return true;
+	}
 	if( int err = _out.Send(_socket, &sent) )
 	{
 		if( WSAEWOULDBLOCK == err )
@@ -6,6 +6,8 @@
 #include "Socket.h"
 #include "Variant.h"
 
+class LoopbackLink;
+
 /*
 struct
 {
@@ -22,6 +24,7 @@ class Peer : public RefCounted
 {
 public:
 	Peer(SOCKET s);
+	Peer(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut); // in-process connection
 	virtual ~Peer();
 
 	void Close();
@@ -52,10 +55,14 @@ public:
 
 private:
 	void OnSocketEvent();
+	void OnLinkEvent();
+	bool ParseInput(); // returns false if disconnected
 	void ProcessInput();
 	bool TrySend();
 
 	Socket _socket;
+	SafePtr<LoopbackLink> _linkIn;
+	SafePtr<LoopbackLink> _linkOut;
 
 	DataStream _in;
 	DataStream _out;
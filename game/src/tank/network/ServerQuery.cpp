@@ -0,0 +1,214 @@
+// ServerQuery.cpp
+
+#include "stdafx.h"
+#include "ServerQuery.h"
+
+#include "core/Application.h"
+#include "core/debug.h"
+
+#include "config/Config.h"
+
+#include "functions.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+ServerQuery::ServerQuery()
+  : _pending(0)
+  , _generation(0)
+  , _timer(CreateWaitableTimer(NULL, FALSE, NULL))
+{
+	if( !_timer || INVALID_HANDLE_VALUE == _timer )
+	{
+		throw std::runtime_error("query: failed to create waitable timer");
+	}
+	QueryPerformanceFrequency(&_frequency);
+	g_app->RegisterHandle(_timer, CreateDelegate(&ServerQuery::OnTimer, this));
+}
+
+ServerQuery::~ServerQuery()
+{
+	if( INVALID_SOCKET != _socket )
+	{
+		_socket.Close();
+	}
+	g_app->UnregisterHandle(_timer);
+	CloseHandle(_timer);
+}
+
+void ServerQuery::Probe(const std::vector<std::string> &addresses)
+{
+	Cancel();
+	g_app->InitNetwork();
+
+	SOCKET s = socket(PF_INET, SOCK_DGRAM, 0);
+	if( INVALID_SOCKET == s )
+	{
+		TRACE("query: unable to create socket - %s", StrFromErr(WSAGetLastError()).c_str());
+		Finish();
+		return;
+	}
+
+	_socket.Attach(s);
+	if( _socket.SetEvents(FD_READ) )
+	{
+		TRACE("query: unable to select event - %s", StrFromErr(WSAGetLastError()).c_str());
+		_socket.Close();
+		Finish();
+		return;
+	}
+	_socket.SetCallback(CreateDelegate(&ServerQuery::OnSocketEvent, this));
+
+	++_generation;
+	_addresses = addresses;
+	_targets.resize(addresses.size());
+
+	for( size_t i = 0; i < addresses.size(); ++i )
+	{
+		Target &t = _targets[i];
+		t.sent = 0;
+
+		std::istringstream buf(addresses[i]);
+		std::string host;
+		std::getline(buf, host, ':');
+		unsigned short port = g_conf.sv_port.GetInt();
+		buf >> port;
+
+		// the lobby lists numeric addresses, so no name resolution here
+		memset(&t.addr, 0, sizeof(t.addr));
+		t.addr.sin_family = AF_INET;
+		t.addr.sin_port = htons(port);
+		t.addr.sin_addr.s_addr = inet_addr(host.c_str());
+		if( INADDR_NONE == t.addr.sin_addr.s_addr )
+		{
+			TRACE("query: invalid server address '%s'", addresses[i].c_str());
+			continue;
+		}
+
+		ServerQueryRequest req = {0};
+		req.magic = SERVER_QUERY_MAGIC;
+		req.cookie = ((DWORD) _generation << 16) | (DWORD) i;
+
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		if( SOCKET_ERROR == sendto(_socket, (const char *) &req, sizeof(req), 0, (const sockaddr *) &t.addr, sizeof(t.addr)) )
+		{
+			TRACE("query: sendto '%s' failed - %d", addresses[i].c_str(), WSAGetLastError());
+			continue;
+		}
+		t.sent = now.QuadPart;
+		++_pending;
+	}
+
+	if( _pending )
+	{
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -20000000; // 2 seconds
+		SetWaitableTimer(_timer, &dueTime, 0, NULL, NULL, FALSE);
+	}
+	else
+	{
+		Finish();
+	}
+}
+
+void ServerQuery::Cancel()
+{
+	CancelWaitableTimer(_timer);
+	if( INVALID_SOCKET != _socket )
+	{
+		_socket.Close();
+	}
+	_addresses.clear();
+	_targets.clear();
+	_pending = 0;
+}
+
+void ServerQuery::Finish()
+{
+	Cancel();
+	if( eventDone )
+	{
+		INVOKE(eventDone) ();
+	}
+}
+
+void ServerQuery::OnSocketEvent()
+{
+	WSANETWORKEVENTS ne = {0};
+	if( _socket.EnumNetworkEvents(&ne) )
+	{
+		TRACE("query: EnumNetworkEvents error 0x%08x", WSAGetLastError());
+		return;
+	}
+
+	for(;;)
+	{
+		ServerQueryReply reply;
+		sockaddr_in from;
+		int fromlen = sizeof(from);
+		int size = recvfrom(_socket, (char *) &reply, sizeof(reply), 0, (sockaddr *) &from, &fromlen);
+		if( SOCKET_ERROR == size )
+		{
+			int err = WSAGetLastError();
+			if( WSAECONNRESET == err || WSAEMSGSIZE == err )
+				continue; // unreachable server on windows or an oversized datagram
+			if( WSAEWOULDBLOCK != err )
+				TRACE("query: recvfrom error %d", err);
+			break;
+		}
+
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+
+		size_t idx = reply.cookie & 0xffff;
+		if( sizeof(reply) != size || SERVER_QUERY_MAGIC != reply.magic
+			|| (reply.cookie >> 16) != _generation || idx >= _targets.size() )
+		{
+			continue; // not ours or late reply to a previous probe
+		}
+
+		Target &t = _targets[idx];
+		if( !t.sent || t.addr.sin_addr.s_addr != from.sin_addr.s_addr || t.addr.sin_port != from.sin_port )
+		{
+			continue;
+		}
+
+		reply.cMapName[sizeof(reply.cMapName) - 1] = 0;
+		reply.cServerName[sizeof(reply.cServerName) - 1] = 0;
+
+		ServerInfo info;
+		info.address = _addresses[idx];
+		info.name = reply.cServerName;
+		info.map = reply.cMapName;
+		info.compatible = 0 == memcmp(reply.exeVer, g_md5.bytes, sizeof(reply.exeVer));
+		info.players = reply.players;
+		info.fps = reply.server_fps;
+		info.rtt = (float) (now.QuadPart - t.sent) / (float) _frequency.QuadPart;
+
+		t.sent = 0;
+		--_pending;
+
+		if( eventInfo )
+		{
+			INVOKE(eventInfo) (info);
+			if( INVALID_SOCKET == _socket )
+			{
+				break; // cancelled by the handler
+			}
+		}
+
+		if( 0 == _pending )
+		{
+			Finish();
+			break;
+		}
+	}
+}
+
+void ServerQuery::OnTimer()
+{
+	Finish();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
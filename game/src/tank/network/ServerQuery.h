@@ -0,0 +1,86 @@
+// ServerQuery.h
+
+#pragma once
+
+#include "Socket.h"
+#include "CommonTypes.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// connectionless server info query. the request is a single datagram sent to
+// the game port over UDP; the server answers with the game description so the
+// client can show the server without connecting to it.
+
+#define SERVER_QUERY_MAGIC    0x4f46495a // "ZIFO"
+
+struct ServerQueryReply
+{
+	DWORD magic;
+	DWORD cookie;
+	char  exeVer[16];      // md5 of the server executable
+	char  cMapName[MAX_PATH];
+	char  cServerName[MAX_SRVNAME];
+	short server_fps;
+	short players;
+};
+
+// padded to the size of the reply so that a spoofed source address does not
+// make the server send more bytes than it received; shorter requests are ignored
+struct ServerQueryRequest
+{
+	DWORD magic;
+	DWORD cookie;  // returned in the reply
+	char  padding[sizeof(ServerQueryReply) - 2 * sizeof(DWORD)]; // zero
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ServerInfo
+{
+	std::string address;   // as given to Probe
+	std::string name;
+	std::string map;
+	bool  compatible;      // runs the same executable as the client
+	int   players;
+	int   fps;
+	float rtt;             // seconds
+};
+
+// probes all servers at once and reports every reply as it arrives
+class ServerQuery : public RefCounted
+{
+public:
+	ServerQuery();
+	virtual ~ServerQuery();
+
+	// a new probe cancels the previous one; eventDone follows when every server
+	// has answered or the time is out
+	void Probe(const std::vector<std::string> &addresses);
+	void Cancel();
+
+	Delegate<void(const ServerInfo&)> eventInfo;
+	Delegate<void()> eventDone;
+
+private:
+	struct Target
+	{
+		sockaddr_in addr;
+		LONGLONG    sent;      // performance counter; 0 if answered or not sent
+	};
+
+	std::vector<std::string> _addresses;
+	std::vector<Target> _targets;
+	size_t _pending;
+	WORD   _generation;        // high word of the cookie
+	LARGE_INTEGER _frequency;
+
+	Socket _socket;
+	HANDLE _timer;
+
+	void Finish();
+
+	void OnSocketEvent();
+	void OnTimer();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
@@ -14,6 +14,7 @@
 #include "Level.h"
 
 #include "LobbyClient.h"
+#include "ServerQuery.h"
 
 #include "functions.h"
 
@@ -30,6 +31,15 @@ PeerServer::PeerServer(SOCKET s_)
 {
 }
 
+PeerServer::PeerServer(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut)
+  : Peer(linkIn, linkOut)
+  , ctrlValid(false)
+  , descValid(false)
+  , svlatency(0)
+  , clboost(1)
+{
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TankServer::TankServer(const GameInfo &info, const SafePtr<LobbyClient> &announcer)
@@ -62,12 +72,36 @@ TankServer::TankServer(const GameInfo &info, const SafePtr<LobbyClient> &announc
 
 	_socketListen.SetCallback(CreateDelegate(&TankServer::OnListenerEvent, this));
 
+	// the server stays usable without the info query, so errors are not fatal
+	SOCKET q = socket(PF_INET, SOCK_DGRAM, 0);
+	if( INVALID_SOCKET != q )
+	{
+		_socketQuery.Attach(q);
+		if( bind(_socketQuery, (sockaddr *) &addr, sizeof(sockaddr_in)) || _socketQuery.SetEvents(FD_READ) )
+		{
+			TRACE("sv: Info query is not available - %s", StrFromErr(WSAGetLastError()).c_str());
+			_socketQuery.Close();
+		}
+		else
+		{
+			_socketQuery.SetCallback(CreateDelegate(&TankServer::OnQueryEvent, this));
+		}
+	}
+
 	if( _announcer )
 		_announcer->AnnounceHost(g_conf.sv_port.GetInt());
 
 	TRACE("Server is online!");
 }
 
+TankServer::TankServer(const GameInfo &info)
+  : _connectedCount(0)
+  , _frameReadyCount(0)
+  , _gameInfo(info)
+{
+	TRACE("Server is online (in-process)");
+}
+
 TankServer::~TankServer(void)
 {
 	TRACE("Server is shutting down");
@@ -88,6 +122,9 @@ TankServer::~TankServer(void)
 	if( INVALID_SOCKET != _socketListen )
 		_socketListen.Close();
 
+	if( INVALID_SOCKET != _socketQuery )
+		_socketQuery.Close();
+
 
 	//
 	// disconnect clients
@@ -127,12 +164,61 @@ void TankServer::OnListenerEvent()
 
 	TRACE("sv: Client connected");
 
+	AddClient(SafePtr<PeerServer>(new PeerServer(s)));
+}
 
-	//
-	// Add new client
-	//
+void TankServer::OnQueryEvent()
+{
+	WSANETWORKEVENTS ne = {0};
+	if( _socketQuery.EnumNetworkEvents(&ne) )
+	{
+		TRACE("sv: EnumNetworkEvents error 0x%08x", WSAGetLastError());
+		return;
+	}
 
-	_clients.push_back(SafePtr<PeerServer>(new PeerServer(s)));
+	for(;;)
+	{
+		ServerQueryRequest req;
+		sockaddr_in from;
+		int fromlen = sizeof(from);
+		int size = recvfrom(_socketQuery, (char *) &req, sizeof(req), 0, (sockaddr *) &from, &fromlen);
+		if( SOCKET_ERROR == size )
+		{
+			int err = WSAGetLastError();
+			if( WSAECONNRESET == err || WSAEMSGSIZE == err )
+				continue; // a client that has gone or an oversized datagram
+			if( WSAEWOULDBLOCK != err )
+				TRACE("sv: query recvfrom error %d", err);
+			break;
+		}
+		if( sizeof(req) != size || SERVER_QUERY_MAGIC != req.magic )
+		{
+			continue;
+		}
+
+		ServerQueryReply reply = {0};
+		reply.magic = SERVER_QUERY_MAGIC;
+		reply.cookie = req.cookie;
+		memcpy(reply.exeVer, _gameInfo.exeVer, sizeof(reply.exeVer));
+		memcpy(reply.cMapName, _gameInfo.cMapName, sizeof(reply.cMapName));
+		memcpy(reply.cServerName, _gameInfo.cServerName, sizeof(reply.cServerName));
+		reply.server_fps = _gameInfo.server_fps;
+		reply.players = _connectedCount;
+
+		sendto(_socketQuery, (const char *) &reply, sizeof(reply), 0, (const sockaddr *) &from, fromlen);
+	}
+}
+
+void TankServer::Accept(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut)
+{
+	TRACE("sv: Client connected (in-process)");
+
+	AddClient(SafePtr<PeerServer>(new PeerServer(linkIn, linkOut)));
+}
+
+void TankServer::AddClient(const SafePtr<PeerServer> &peer)
+{
+	_clients.push_back(peer);
 	PeerServer &cl = *_clients.back();
 
 	cl.RegisterHandler<std::string>(SV_POST_TEXTMESSAGE, CreateDelegate(&TankServer::SvTextMessage, this));
@@ -349,7 +435,8 @@ void TankServer::SvPlayerReady(Peer *from, int task, const Variant &arg)
 
 	if( bAllPlayersReady )
 	{
-		_socketListen.Close();
+		if( INVALID_SOCKET != _socketListen )
+			_socketListen.Close();
 		if( _announcer )
 			_announcer->Cancel();
 		BroadcastTextMessage(g_lang.net_msg_starting_game.Get());
@@ -377,7 +464,6 @@ void TankServer::SvPlayerInfo(Peer *from, int task, const Variant &arg)
 	if( !who->descValid )
 	{
 		// TODO: tell newly connected player about other players
-		assert(false);
 //		for( size_t i = 0; i < _players.size(); ++i )
 //		{
 //			who->Post(_players[i].first, _players[i].second);
@@ -26,6 +26,7 @@ public:
 	bool                ctrlValid;
 
 	PeerServer(SOCKET s_);
+	PeerServer(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -44,6 +45,7 @@ class TankServer
 
 
 	Socket _socketListen;
+	Socket _socketQuery;   // answers server info queries
 
 	SafePtr<LobbyClient> _announcer;
 
@@ -54,7 +56,9 @@ class TankServer
 
 	void SendFrame();
 
+	void AddClient(const SafePtr<PeerServer> &peer);
 	void OnListenerEvent();
+	void OnQueryEvent();
 	void OnDisconnect(Peer *who, int err);
 
 	void BroadcastTextMessage(const std::string &msg);
@@ -68,8 +72,11 @@ class TankServer
 
 public:
 	TankServer(const GameInfo &info, const SafePtr<LobbyClient> &announcer);
+	explicit TankServer(const GameInfo &info); // no listener; clients are attached with Accept
 	~TankServer();
 
+	void Accept(const SafePtr<LoopbackLink> &linkIn, const SafePtr<LoopbackLink> &linkOut);
+
 	std::string GetStats() const;
 };
 
@@ -2,6 +2,7 @@
 
 #include "stdafx.h"
 #include "Variant.h"
+#include "LoopbackLink.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -200,6 +201,41 @@ int DataStream::Recv(SOCKET s)
 	return recv(s, &_buffer[offset], pending, 0);
 }
 
+int DataStream::Send(LoopbackLink &link, size_t *outSent)
+{
+	assert(_serialization);
+	assert(0 == _entityLevel);
+
+	size_t sent = _buffer.size();
+	if( sent )
+	{
+		link.Write(&_buffer.front(), sent);
+		_buffer.clear();
+	}
+
+	if( outSent )
+	{
+		*outSent = sent;
+	}
+
+	return 0;
+}
+
+int DataStream::Recv(LoopbackLink &link)
+{
+	assert(!_serialization);
+	assert(0 == _entityLevel);
+
+	size_t pending = link.GetAvailable();
+	if( 0 == pending )
+		return 0;
+
+	size_t offset = _buffer.size();
+	_buffer.resize(_buffer.size() + pending);
+
+	return link.Read(&_buffer[offset], pending);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Variant static members
 
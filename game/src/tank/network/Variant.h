@@ -4,6 +4,8 @@
 
 #define VARIANT_DEBUG
 
+class LoopbackLink;
+
 class DataStream
 {
 public:
@@ -20,6 +22,9 @@ public:
 	int Send(SOCKET s, size_t *outSent = NULL);
 	int Recv(SOCKET s);
 
+	int Send(LoopbackLink &link, size_t *outSent = NULL);
+	int Recv(LoopbackLink &link);
+
 	size_t GetTraffic() const;
 	size_t GetPending() const { return _buffer.size(); }
 
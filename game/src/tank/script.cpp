@@ -24,11 +24,13 @@
 #include "gc/Sound.h"
 
 #include "core/debug.h"
+#include "core/Profiler.h"
 
 #include "video/TextureManager.h"
 
 #include "network/TankClient.h"
 #include "network/TankServer.h"
+#include "network/NetSim.h"
 
 #include "functions.h"
 
@@ -115,43 +117,36 @@ static int luaT_objnextprop(lua_State *L)
 		luaL_argerror(L, 1, "reference to dead object");
 	}
 
-	SafePtr<PropertySet> properties = (*ppObj)->GetProperties();
-	assert(properties);
+	const char *key = lua_isnil(L, 2) ? NULL : luaL_checkstring(L, 2);
 
-	if( lua_isnil(L, 2) )
+	// lua errors skip destructors, so none is raised while the binding is alive
+	bool invalidKey = false;
 	{
-		// begin iteration
-		ObjectProperty *p = properties->GetProperty(0);
-		lua_pushstring(L, p->GetName().c_str()); // key
-		pushprop(L, p); // value
-		return 2;
-	}
-
-	const char *key = luaL_checkstring(L, 2);
+		PropertyTable::Binding properties(*ppObj);
 
-	bool found = false;
-	int count = properties->GetCount();
-	for( int i = 0; i < count; ++i )
-	{
-		ObjectProperty *p = properties->GetProperty(i);
-		if( found )
+		int next = 0; // begin iteration
+		if( key )
 		{
-			// return next pair
-			lua_pushstring(L, p->GetName().c_str()); // key
-			pushprop(L, p); // value
-			return 2;
+			int index = properties.Find(key);
+			invalidKey = (-1 == index);
+			next = index + 1;
 		}
-		else if( p->GetName() == key )
+
+		if( !invalidKey )
 		{
-			found = true;
-		}
-	}
+			if( next < properties->GetCount() )
+			{
+				// return next pair
+				ObjectProperty *p = properties->GetProperty(next);
+				lua_pushstring(L, p->GetName().c_str()); // key
+				pushprop(L, p); // value
+				return 2;
+			}
 
-	if( found )
-	{
-		// end of list
-		lua_pushnil(L);
-		return 1;
+			// end of list
+			lua_pushnil(L);
+			return 1;
+		}
 	}
 
 	return luaL_error(L, "invalid key to 'next'");
@@ -259,6 +254,128 @@ static int luaT_game(lua_State *L)
 	return 0;
 }
 
+// netsim(clients, seconds [, latency_ms, jitter_ms, loss_percent, bytes_per_second, seed])
+// ends the current game since the replays need the level
+static int luaT_netsim(lua_State *L)
+{
+	int n = lua_gettop(L);
+	if( n < 2 || n > 7 )
+		return luaL_error(L, "wrong number of arguments: 2 to 7 expected, got %d", n);
+
+	if( !g_level->IsSafeMode() )
+		return luaL_error(L, "attempt to execute 'netsim' in unsafe mode");
+
+	int clients = luaL_checkint(L, 1);
+	float duration = (float) luaL_checknumber(L, 2);
+	if( clients < 1 )
+		return luaL_argerror(L, 1, "at least one client expected");
+
+	LinkSettings ls;
+	ls.latency = (float) luaL_optnumber(L, 3, 0) / 1000.0f;
+	ls.jitter = (float) luaL_optnumber(L, 4, 0) / 1000.0f;
+	ls.loss = std::max(0.0f, std::min(0.99f, (float) luaL_optnumber(L, 5, 0) / 100.0f));
+	ls.bandwidth = (size_t) luaL_optnumber(L, 6, 0);
+	unsigned long seed = (unsigned long) luaL_optnumber(L, 7, 1);
+
+	SAFE_DELETE(g_client); // it will clear level, message area, command queue
+
+	bool ok;
+	try
+	{
+		NetSimulator sim(clients, ls, seed);
+		ok = sim.Run(duration);
+		sim.PrintReport();
+	}
+	catch( const std::exception &e )
+	{
+		return luaL_error(L, "%s", e.what());
+	}
+
+	lua_pushboolean(L, ok);
+	return 1;
+}
+
+// dettest([players, frames, reference]) plays a fixed scenario and compares the
+// level state with the reference file, which the first run writes
+static int luaT_dettest(lua_State *L)
+{
+	int n = lua_gettop(L);
+	if( n > 3 )
+		return luaL_error(L, "wrong number of arguments: 0 to 3 expected, got %d", n);
+
+	if( !g_level->IsSafeMode() )
+		return luaL_error(L, "attempt to execute 'dettest' in unsafe mode");
+
+	int players = luaL_optint(L, 1, 4);
+	int frames = luaL_optint(L, 2, 1000);
+	const char *refName = luaL_optstring(L, 3, "dettest.ref");
+	if( players < 1 )
+		return luaL_argerror(L, 1, "at least one player expected");
+	if( frames < 0 )
+		return luaL_argerror(L, 2, "negative frame count");
+
+	SAFE_DELETE(g_client); // it will clear level, message area, command queue
+
+	bool ok;
+	try
+	{
+		ok = RunDetTest(players, frames, refName);
+	}
+	catch( const std::exception &e )
+	{
+		return luaL_error(L, "dettest: %s", e.what());
+	}
+
+	lua_pushboolean(L, ok);
+	return 1;
+}
+
+// print live and peak object counts, all and empty blocks of the memory pools
+static int luaT_mempool(lua_State *L)
+{
+	size_t totalLive = 0;
+	size_t totalBlocks = 0;
+	for( MemoryPoolBase *pool = MemoryPoolBase::GetFirst(); pool; pool = pool->GetNext() )
+	{
+		if( pool->GetPeakCount() )
+		{
+			GetConsole().Printf(0, "%8u %8u %4u %4u  %s", (unsigned int) pool->GetLiveCount(),
+				(unsigned int) pool->GetPeakCount(), (unsigned int) pool->GetBlockCount(),
+				(unsigned int) pool->GetEmptyBlockCount(), pool->GetName());
+		}
+		totalLive += pool->GetLiveCount() * pool->GetObjectSize();
+		totalBlocks += pool->GetBlockCount();
+	}
+	GetConsole().Printf(0, "%u bytes in use, %u blocks", (unsigned int) totalLive, (unsigned int) totalBlocks);
+	return 0;
+}
+
+// write recent profiler scopes in the Chrome trace format
+static int luaT_profdump(lua_State *L)
+{
+	int n = lua_gettop(L);
+	if( n > 1 )
+		return luaL_error(L, "wrong number of arguments: 0 or 1 expected, got %d", n);
+
+	const char *filename = luaL_optstring(L, 1, "trace.json");
+
+	std::ostringstream out;
+	size_t count = ProfileScope::DumpTrace(out);
+
+	try
+	{
+		string_t buf = out.str();
+		g_fs->Open(filename, FS::ModeWrite)->QueryStream()->Write(buf.data(), buf.size());
+	}
+	catch( const std::exception &e )
+	{
+		return luaL_error(L, "couldn't write trace to '%s' - %s", filename, e.what());
+	}
+
+	GetConsole().Printf(0, "%u events written to '%s'", (unsigned int) count, filename);
+	return 0;
+}
+
 // start/stop the timer
 static int luaT_pause(lua_State *L)
 {
@@ -668,28 +785,22 @@ int luaT_ConvertVehicleClass(lua_State *L)
 
 
 // prop name at -2; prop value at -1
-// return false if property not found
-int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
+// returns 1 on success, 0 if property not found or -1 if the value is not
+// acceptable; in the last case the error message is pushed onto the stack.
+// the caller raises the error when the binding is released because lua
+// errors skip the destructors.
+int pset_helper(const PropertyTable::Binding &properties, lua_State *L)
 {
 	const char *pname = lua_tostring(L, -2);
 
-	ObjectProperty *p = NULL;
-
-	for( int i = 0; i < properties->GetCount(); ++i )
-	{
-		p = properties->GetProperty(i);
-		if( p->GetName() == pname )
-		{
-			break;
-		}
-		p = NULL;
-	}
-
-	if( NULL == p )
+	int index = properties.Find(pname);
+	if( -1 == index )
 	{
 		return 0;  // property not found
 	}
 
+	ObjectProperty *p = properties->GetProperty(index);
+
 
 	switch( p->GetType() )
 	{
@@ -697,14 +808,16 @@ int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
 	{
 		if( LUA_TNUMBER != lua_type(L, -1) )
 		{
-			luaL_error(L, "property '%s' - expected integer value; got %s",
+			lua_pushfstring(L, "property '%s' - expected integer value; got %s",
 				pname, lua_typename(L, lua_type(L, -1)));
+			return -1;
 		}
 		int v = lua_tointeger(L, -1);
 		if( v < p->GetIntMin() || v > p->GetIntMax() )
 		{
-			return luaL_error(L, "property '%s' - value %d is out of range [%d, %d]",
+			lua_pushfstring(L, "property '%s' - value %d is out of range [%d, %d]",
 				pname, v, p->GetIntMin(), p->GetIntMax());
+			return -1;
 		}
 		p->SetIntValue(v);
 		break;
@@ -713,14 +826,16 @@ int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
 	{
 		if( LUA_TNUMBER != lua_type(L, -1) )
 		{
-			luaL_error(L, "property '%s' - expected number value; got %s",
+			lua_pushfstring(L, "property '%s' - expected number value; got %s",
 				pname, lua_typename(L, lua_type(L, -1)));
+			return -1;
 		}
 		float v = (float) lua_tonumber(L, -1);
 		if( v < p->GetFloatMin() || v > p->GetFloatMax() )
 		{
-			return luaL_error(L, "property '%s' - value %g is out of range [%g, %g]",
-				pname, v, p->GetFloatMin(), p->GetFloatMax());
+			lua_pushfstring(L, "property '%s' - value %f is out of range [%f, %f]",
+				pname, (double) v, (double) p->GetFloatMin(), (double) p->GetFloatMax());
+			return -1;
 		}
 		p->SetFloatValue(v);
 		break;
@@ -729,8 +844,9 @@ int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
 	{
 		if( LUA_TSTRING != lua_type(L, -1) )
 		{
-			luaL_error(L, "property '%s' - expected string value; got %s",
+			lua_pushfstring(L, "property '%s' - expected string value; got %s",
 				pname, lua_typename(L, lua_type(L, -1)));
+			return -1;
 		}
 		p->SetStringValue(lua_tostring(L, -1));
 		break;
@@ -739,8 +855,9 @@ int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
 	{
 		if( LUA_TSTRING != lua_type(L, -1) )
 		{
-			luaL_error(L, "property '%s' - expected string value; got %s",
+			lua_pushfstring(L, "property '%s' - expected string value; got %s",
 				pname, lua_typename(L, lua_type(L, -1)));
+			return -1;
 		}
 		const char *v = lua_tostring(L, -1);
 		bool ok = false;
@@ -755,7 +872,8 @@ int pset_helper(const SafePtr<PropertySet> &properties, lua_State *L)
 		}
 		if( !ok )
 		{
-			return luaL_error(L, "property '%s' - attempt to set invalid value '%s'", pname, v);
+			lua_pushfstring(L, "property '%s' - attempt to set invalid value '%s'", pname, v);
+			return -1;
 		}
 		break;
 	}
@@ -797,16 +915,29 @@ int luaT_actor(lua_State *L)
 	{
 		luaL_checktype(L, 4, LUA_TTABLE);
 
-		SafePtr<PropertySet> properties = obj->GetProperties();
-		assert(properties);
+		int result = 1;
+		{
+			PropertyTable::Binding properties(obj);
+
+			for( lua_pushnil(L); lua_next(L, -2); lua_pop(L, 1) )
+			{
+				// now 'key' is at index -2 and 'value' at index -1
+				result = pset_helper(properties, L);
+				if( -1 == result )
+				{
+					break; // error message on top of the stack
+				}
+			}
 
-		for( lua_pushnil(L); lua_next(L, -2); lua_pop(L, 1) )
+			if( -1 != result )
+			{
+				properties->Exchange(true);
+			}
+		}
+		if( -1 == result )
 		{
-			// now 'key' is at index -2 and 'value' at index -1
-			pset_helper(properties, L);
+			return lua_error(L);
 		}
-
-		properties->Exchange(true);
 	}
 
 	luaT_pushobject(L, obj);
@@ -842,16 +973,29 @@ int luaT_service(lua_State *L)
 	{
 		luaL_checktype(L, 2, LUA_TTABLE);
 
-		SafePtr<PropertySet> properties = obj->GetProperties();
-		assert(properties);
+		int result = 1;
+		{
+			PropertyTable::Binding properties(obj);
+
+			for( lua_pushnil(L); lua_next(L, -2); lua_pop(L, 1) )
+			{
+				// now 'key' is at index -2 and 'value' at index -1
+				result = pset_helper(properties, L);
+				if( -1 == result )
+				{
+					break; // error message on top of the stack
+				}
+			}
 
-		for( lua_pushnil(L); lua_next(L, -2); lua_pop(L, 1) )
+			if( -1 != result )
+			{
+				properties->Exchange(true);
+			}
+		}
+		if( -1 == result )
 		{
-			// now 'key' is at index -2 and 'value' at index -1
-			pset_helper(properties, L);
+			return lua_error(L);
 		}
-
-		properties->Exchange(true);
 	}
 
 	luaT_pushobject(L, obj);
@@ -989,19 +1133,18 @@ int luaT_pget(lua_State *L)
 	GC_Object *obj = luaT_checkobject(L, 1);
 	const char *prop = luaL_checkstring(L, 2);
 
-	SafePtr<PropertySet> properties = obj->GetProperties();
-	assert(properties);
-
-	for( int i = 0; i < properties->GetCount(); ++i )
 	{
-		ObjectProperty *p = properties->GetProperty(i);
-		if( p->GetName() == prop )
+		PropertyTable::Binding properties(obj);
+
+		int index = properties.Find(prop);
+		if( -1 != index )
 		{
-			pushprop(L, p);
+			pushprop(L, properties->GetProperty(index));
 			return 1;
 		}
 	}
 
+	// raised after the binding is released
 	return luaL_error(L, "object of type '%s' has no property '%s'", 
 		RTTypes::Inst().GetTypeName(obj->GetType()), prop);
 }
@@ -1020,17 +1163,28 @@ int luaT_pset(lua_State *L)
 	const char *prop = luaL_checkstring(L, 2);
 	luaL_checkany(L, 3);  // prop value should be here
 
-	SafePtr<PropertySet> properties = obj->GetProperties();
-	assert(properties);
+	int result;
+	{
+		PropertyTable::Binding properties(obj);
 
-	// prop name at -2; prop value at -1
-	if( !pset_helper(properties, L) )
+		// prop name at -2; prop value at -1
+		result = pset_helper(properties, L);
+		if( 1 == result )
+		{
+			properties->Exchange(true);
+		}
+	}
+
+	// errors are raised after the binding is released
+	if( -1 == result )
+	{
+		return lua_error(L);
+	}
+	if( 0 == result )
 	{
 		return luaL_error(L, "object of type '%s' has no property '%s'", 
 			RTTypes::Inst().GetTypeName(obj->GetType()), prop);
 	}
-
-	properties->Exchange(true);
 	return 0;
 }
 
@@ -1285,6 +1439,10 @@ lua_State* script_open(void)
 	lua_register(L, "quit",     luaT_quit);
 	lua_register(L, "pause",    luaT_pause);
 	lua_register(L, "freeze",   luaT_freeze);
+	lua_register(L, "netsim",   luaT_netsim);
+	lua_register(L, "dettest",  luaT_dettest);
+	lua_register(L, "mempool",  luaT_mempool);
+	lua_register(L, "profdump", luaT_profdump);
 //	lua_register(L, "play_sound",   luaT_PlaySound);
 	lua_register(L, "setposition", luaT_setposition);
 
@@ -52,6 +52,14 @@
 # include <windows.h>
 # include <commctrl.h>
 # include <io.h>
+#else
+# include <errno.h>
+# include <unistd.h>
+# include <dirent.h>
+# include <fnmatch.h>
+# include <strings.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
 #endif
 
 #include <stdio.h>
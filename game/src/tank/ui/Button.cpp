@@ -23,6 +23,7 @@ void ButtonBase::SetState(State s)
 	if( _state != s )
 	{
 		_state = s;
+		Invalidate();
 		OnChangeState(s);
 	}
 }
@@ -135,8 +136,10 @@ void Button::OnChangeState(State state)
 	SetFrame(state);
 }
 
-void Button::DrawChildren(const DrawingContext *dc, float sx, float sy) const
+void Button::DrawCached(const DrawingContext *dc) const
 {
+	__super::DrawCached(dc);
+
 	float x = GetWidth() / 2;
 	float y = GetHeight() / 2;
 	SpriteColor c = 0;
@@ -159,9 +162,7 @@ void Button::DrawChildren(const DrawingContext *dc, float sx, float sy) const
 		assert(false);
 	}
 
-	dc->DrawBitmapText(sx + x, sy + y, _font, c, GetText(), alignTextCC);
-
-	__super::DrawChildren(dc, sx, sy);
+	dc->DrawBitmapText(x, y, _font, c, GetText(), alignTextCC);
 }
 
 
@@ -199,6 +200,7 @@ void TextButton::AlignSizeToContent()
 void TextButton::SetDrawShadow(bool drawShadow)
 {
 	_drawShadow = drawShadow;
+	Invalidate();
 }
 
 bool TextButton::GetDrawShadow() const
@@ -210,6 +212,7 @@ void TextButton::SetFont(const char *fontName)
 {
 	_fontTexture = GetManager()->GetTextureManager()->FindSprite(fontName);
 	AlignSizeToContent();
+	Invalidate();
 }
 
 void TextButton::OnTextChange()
@@ -217,8 +220,10 @@ void TextButton::OnTextChange()
 	AlignSizeToContent();
 }
 
-void TextButton::DrawChildren(const DrawingContext *dc, float sx, float sy) const
+void TextButton::DrawCached(const DrawingContext *dc) const
 {
+	__super::DrawCached(dc);
+
 	// grep 'enum State'
 	SpriteColor colors[] = 
 	{
@@ -229,10 +234,9 @@ void TextButton::DrawChildren(const DrawingContext *dc, float sx, float sy) cons
 	};
 	if( _drawShadow && stateDisabled != GetState() )
 	{
-		dc->DrawBitmapText(sx + 1, sy + 1, _fontTexture, 0xff000000, GetText());
+		dc->DrawBitmapText(1, 1, _fontTexture, 0xff000000, GetText());
 	}
-	dc->DrawBitmapText(sx, sy, _fontTexture, colors[GetState()], GetText());
-	__super::DrawChildren(dc, sx, sy);
+	dc->DrawBitmapText(0, 0, _fontTexture, colors[GetState()], GetText());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -309,13 +313,15 @@ void CheckBox::OnChangeState(State state)
 	SetFrame(_isChecked ? state+4 : state);
 }
 
-void CheckBox::DrawChildren(const DrawingContext *dc, float sx, float sy) const
+void CheckBox::DrawCached(const DrawingContext *dc) const
 {
+	__super::DrawCached(dc);
+
 	float bh = dc->GetFrameHeight(_boxTexture, GetFrame());
 	float bw = dc->GetFrameWidth(_boxTexture, GetFrame());
 	float th = dc->GetFrameHeight(_fontTexture, 0);
 
-	FRECT box = {sx, sy + (GetHeight() - bh) / 2, sx + bw, sy + (GetHeight() - bh) / 2 + bh};
+	FRECT box = {0, (GetHeight() - bh) / 2, bw, (GetHeight() - bh) / 2 + bh};
 	dc->DrawSprite(&box, _boxTexture, GetBackColor(), GetFrame());
 
 	// grep 'enum State'
@@ -328,11 +334,9 @@ void CheckBox::DrawChildren(const DrawingContext *dc, float sx, float sy) const
 	};
 	if( _drawShadow && stateDisabled != GetState() )
 	{
-		dc->DrawBitmapText(sx + bw + 1, sy + (GetHeight() - th) / 2 + 1, _fontTexture, 0xff000000, GetText());
+		dc->DrawBitmapText(bw + 1, (GetHeight() - th) / 2 + 1, _fontTexture, 0xff000000, GetText());
 	}
-	dc->DrawBitmapText(sx + bw, sy + (GetHeight() - th) / 2, _fontTexture, colors[GetState()], GetText());
-
-	__super::DrawChildren(dc, sx, sy);
+	dc->DrawBitmapText(bw, (GetHeight() - th) / 2, _fontTexture, colors[GetState()], GetText());
 }
 
 
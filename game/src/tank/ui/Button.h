@@ -57,7 +57,7 @@ public:
 protected:
 	Button(Window *parent);
 	virtual void OnChangeState(State state);
-	virtual void DrawChildren(const DrawingContext *dc, float sx, float sy) const;
+	virtual void DrawCached(const DrawingContext *dc) const;
 
 private:
 	size_t _font;
@@ -81,7 +81,7 @@ protected:
 	void AlignSizeToContent();
 
 	virtual void OnTextChange();
-	virtual void DrawChildren(const DrawingContext *dc, float sx, float sy) const;
+	virtual void DrawCached(const DrawingContext *dc) const;
 
 
 private:
@@ -123,7 +123,7 @@ protected:
 	virtual void OnTextChange();
 	virtual void OnChangeState(State state);
 
-	virtual void DrawChildren(const DrawingContext *dc, float sx, float sy) const;
+	virtual void DrawCached(const DrawingContext *dc) const;
 
 private:
 	size_t _fontTexture;
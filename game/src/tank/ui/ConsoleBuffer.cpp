@@ -79,27 +79,139 @@ ConsoleBuffer::ConsoleBuffer(size_t lineLength, size_t maxLines)
   ,_locked(0)
 #endif
   , _log(NULL)
+  , _queue(QUEUE_SIZE)
+  , _queueTail(0)
+  , _queueHead(0)
+  , _dropped(0)
+  , _stop(0)
 {
 	InitializeCriticalSection(&_cs);
+	InitializeCriticalSection(&_csLog);
+	for( LONG i = 0; i < QUEUE_SIZE; ++i )
+	{
+		_queue[i].sequence = i;
+	}
+	_wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	_writerThread = CreateThread(NULL, 0, WriterProc, this, 0, NULL);
 }
 
 ConsoleBuffer::~ConsoleBuffer()
 {
 	assert(!_locked);
+
+	InterlockedExchange(&_stop, 1);
+	SetEvent(_wakeEvent);
+	WaitForSingleObject(_writerThread, INFINITE);
+	CloseHandle(_writerThread);
+	CloseHandle(_wakeEvent);
+	Drain(); // whatever was written after the writer had stopped
+
 	if( _log )
 	{
 		_log->Release();
 	}
+	DeleteCriticalSection(&_csLog);
 	DeleteCriticalSection(&_cs);
 }
 
 void ConsoleBuffer::SetLog(IConsoleLog *pLog)
 {
+	EnterCriticalSection(&_csLog);
 	if( _log )
 	{
 		_log->Release();
 	}
 	_log = pLog;
+	LeaveCriticalSection(&_csLog);
+}
+
+ConsoleBuffer::Slot* ConsoleBuffer::Reserve()
+{
+	LONG pos = _queueTail;
+	for(;;)
+	{
+		Slot &slot = _queue[pos & (QUEUE_SIZE - 1)];
+		LONG diff = slot.sequence - pos;
+		if( 0 == diff )
+		{
+			LONG prev = InterlockedCompareExchange(&_queueTail, pos + 1, pos);
+			if( prev == pos )
+			{
+				return &slot;
+			}
+			pos = prev; // another thread took it
+		}
+		else if( diff < 0 )
+		{
+			// the writer has not freed this slot yet; never wait for it
+			InterlockedIncrement(&_dropped);
+			return NULL;
+		}
+		else
+		{
+			pos = _queueTail;
+		}
+	}
+}
+
+void ConsoleBuffer::Commit(Slot *slot)
+{
+	InterlockedIncrement(&slot->sequence);
+	SetEvent(_wakeEvent);
+}
+
+void ConsoleBuffer::Drain()
+{
+	for(;;)
+	{
+		Slot &slot = _queue[_queueHead & (QUEUE_SIZE - 1)];
+		if( slot.sequence != _queueHead + 1 )
+		{
+			break; // empty or not committed yet
+		}
+
+		Lock();
+		Append(slot.severity, slot.time, slot.text);
+		Unlock();
+
+		EnterCriticalSection(&_csLog);
+		if( _log )
+		{
+			_log->WriteLine(slot.severity, slot.text);
+		}
+		LeaveCriticalSection(&_csLog);
+
+		InterlockedExchange(&slot.sequence, _queueHead + QUEUE_SIZE);
+		++_queueHead;
+	}
+
+	if( LONG dropped = InterlockedExchange(&_dropped, 0) )
+	{
+		TCHAR text[64];
+		_stprintf_s(text, TEXT("%ld lines were dropped"), dropped);
+
+		Lock();
+		Append(1, GetTickCount(), text);
+		Unlock();
+
+		EnterCriticalSection(&_csLog);
+		if( _log )
+		{
+			_log->WriteLine(1, text);
+		}
+		LeaveCriticalSection(&_csLog);
+	}
+}
+
+DWORD WINAPI ConsoleBuffer::WriterProc(LPVOID param)
+{
+	ConsoleBuffer *self = static_cast<ConsoleBuffer *>(param);
+	do
+	{
+		WaitForSingleObject(self->_wakeEvent, INFINITE);
+		self->Drain();
+	} while( !self->_stop );
+	return 0;
 }
 
 size_t ConsoleBuffer::GetLineCount() const
@@ -139,15 +251,18 @@ unsigned int ConsoleBuffer::GetSeverity(size_t index) const
 
 void ConsoleBuffer::WriteLine(int severity, const string_t &s)
 {
-	Lock();
-
-	const TCHAR *src = s.c_str();
-	DWORD time = GetTickCount();
-
-	if( _log )
+	if( Slot *slot = Reserve() )
 	{
-		_log->WriteLine(severity, s);
+		slot->severity = severity;
+		slot->time = GetTickCount();
+		_tcsncpy_s(slot->text, s.c_str(), _TRUNCATE);
+		Commit(slot);
 	}
+}
+
+void ConsoleBuffer::Append(int severity, DWORD time, const TCHAR *src)
+{
+	assert(_locked);
 
 	TCHAR *dst = GET_LINE(_currentLine);
 
@@ -188,22 +303,22 @@ void ConsoleBuffer::WriteLine(int severity, const string_t &s)
 	_currentPos = 0;
 	_currentLine = (_currentLine + 1) % _lineCount;
 	_currentCount = std::min(_lineCount, _currentCount + 1);
-
-
-	Unlock();
 }
 
 void ConsoleBuffer::Printf(int severity, const char *fmt, ...)
 {
-	va_list args;
-	va_start(args, fmt);
-	int size = _vscprintf(fmt, args) + 1; // check how much space is needed
+	if( Slot *slot = Reserve() )
+	{
+		slot->severity = severity;
+		slot->time = GetTickCount();
 
-	std::vector<char> buf(size);
-	vsprintf(&buf[0], fmt, args);
-	va_end(args);
+		va_list args;
+		va_start(args, fmt);
+		_vsnprintf_s(slot->text, _TRUNCATE, fmt, args);
+		va_end(args);
 
-	WriteLine(severity, &buf[0]);
+		Commit(slot);
+	}
 }
 
 void ConsoleBuffer::Lock() const
@@ -14,9 +14,13 @@ struct IConsoleLog
 	virtual void Release() = 0;
 };
 
+// lines may be written from any thread without waiting. they are queued
+// into preallocated slots and a writer thread moves them to the buffer and
+// to the log; if the writer falls behind, new lines are dropped and counted.
 class ConsoleBuffer
 {
 	IConsoleLog *_log;
+	CRITICAL_SECTION _csLog;  // taken by SetLog and the writer thread only
 
 	std::vector<TCHAR>  _buffer;
 	std::vector<DWORD>  _times;        // time stumps of lines
@@ -34,6 +38,32 @@ class ConsoleBuffer
 	mutable int  _locked;
 #endif
 
+	enum
+	{
+		QUEUE_SIZE  = 1024,  // must be a power of two
+		SLOT_LENGTH = 512,   // longer lines are truncated
+	};
+	struct Slot
+	{
+		volatile LONG sequence;  // equals the queue position when free, position + 1 when filled
+		int    severity;
+		DWORD  time;
+		TCHAR  text[SLOT_LENGTH];
+	};
+	std::vector<Slot> _queue;
+	volatile LONG _queueTail;    // next position to fill
+	LONG          _queueHead;    // next position to read; writer thread only
+	volatile LONG _dropped;      // lines lost since the last report
+	volatile LONG _stop;
+	HANDLE _wakeEvent;
+	HANDLE _writerThread;
+
+	Slot* Reserve();
+	void Commit(Slot *slot);
+	void Drain();
+	void Append(int severity, DWORD time, const TCHAR *src);
+	static DWORD WINAPI WriterProc(LPVOID param);
+
 
 	class StreamHelper
 	{
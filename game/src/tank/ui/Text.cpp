@@ -37,6 +37,7 @@ Text::Text(Window *parent)
 void Text::SetDrawShadow(bool drawShadow)
 {
 	_drawShadow = drawShadow;
+	Invalidate();
 }
 
 bool Text::GetDrawShadow() const
@@ -47,6 +48,7 @@ bool Text::GetDrawShadow() const
 void Text::SetAlign(enumAlignText align)
 {
 	_align = align;
+	Invalidate();
 }
 
 void Text::SetFont(const char *fontName)
@@ -55,11 +57,13 @@ void Text::SetFont(const char *fontName)
 	float w = GetManager()->GetTextureManager()->GetFrameWidth(_fontTexture, 0);
 	float h = GetManager()->GetTextureManager()->GetFrameHeight(_fontTexture, 0);
 	Resize((w - 1) * (float) _maxline, h * (float) _lineCount);
+	Invalidate();
 }
 
 void Text::SetFontColor(SpriteColor color)
 {
 	_fontColor = color;
+	Invalidate();
 }
 
 float Text::GetCharWidth()
@@ -72,14 +76,14 @@ float Text::GetCharHeight()
 	return GetManager()->GetTextureManager()->GetFrameHeight(_fontTexture, 0);
 }
 
-void Text::DrawChildren(const DrawingContext *dc, float sx, float sy) const
+void Text::DrawCached(const DrawingContext *dc) const
 {
+	__super::DrawCached(dc);
 	if( _drawShadow )
 	{
-		dc->DrawBitmapText(sx + 1, sy + 1, _fontTexture, 0xff000000, GetText(), _align);
+		dc->DrawBitmapText(1, 1, _fontTexture, 0xff000000, GetText(), _align);
 	}
-	dc->DrawBitmapText(sx, sy, _fontTexture, _fontColor, GetText(), _align);
-	__super::DrawChildren(dc, sx, sy);
+	dc->DrawBitmapText(0, 0, _fontTexture, _fontColor, GetText(), _align);
 }
 
 void Text::OnTextChange()
@@ -23,12 +23,13 @@ public:
 	float GetCharWidth();
 	float GetCharHeight();
 
-	virtual void DrawChildren(const DrawingContext *dc, float sx, float sy) const;
 	virtual void OnTextChange();
 
 protected:
 	Text(Window *parent);
 
+	virtual void DrawCached(const DrawingContext *dc) const;
+
 private:
 	size_t         _lineCount;
 	size_t         _maxline;
@@ -32,6 +32,8 @@ Window::Window(Window *parent, LayoutManager *manager)
   , _backColor(0xffffffff)
   , _borderColor(0xffffffff)
   , _frame(0)
+  , _isCacheValid(false)
+  , _cacheGeneration(0)
   , _manager(parent ? parent->GetManager() : manager)
   , _parent(parent)
   , _firstChild(NULL)
@@ -171,6 +173,7 @@ void Window::SetTexture(const char *tex, bool fitSize)
 	{
 		_texture = (size_t) -1;
 	}
+	Invalidate();
 }
 
 unsigned int Window::GetFrameCount() const
@@ -183,20 +186,20 @@ void Window::Draw(const DrawingContext *dc, float sx, float sy) const
 	NoDestroyHelper(this);
 	assert(_isVisible);
 
-	//           left     top      right             bottom
-	FRECT dst = {sx + _x, sy + _y, sx + _x + _width, sy + _y + _height};
-
-	if( -1 != _texture )
+	if( !_isCacheValid || _cacheGeneration != dc->GetGeneration() )
 	{
-		if( _drawBackground )
-		{
-			dc->DrawSprite(&dst, _texture, _backColor, _frame);
-		}
-		if( _drawBorder )
-		{
-			 dc->DrawBorder(&dst, _texture, _borderColor, _frame);
-		}
+		IRender *render = g_render;
+		_cache.Begin(render);
+		g_render = &_cache;
+		DrawCached(dc);
+		g_render = render;
+		_isCacheValid = true;
+		_cacheGeneration = dc->GetGeneration();
 	}
+	_cache.Replay(NULL, sx + _x, sy + _y);
+
+	//           left     top      right             bottom
+	FRECT dst = {sx + _x, sy + _y, sx + _x + _width, sy + _y + _height};
 
 	//
 	// draw children windows with optional clipping
@@ -220,6 +223,22 @@ void Window::Draw(const DrawingContext *dc, float sx, float sy) const
 	}
 }
 
+void Window::DrawCached(const DrawingContext *dc) const
+{
+	if( -1 != _texture )
+	{
+		FRECT dst = {0, 0, _width, _height};
+		if( _drawBackground )
+		{
+			dc->DrawSprite(&dst, _texture, _backColor, _frame);
+		}
+		if( _drawBorder )
+		{
+			 dc->DrawBorder(&dst, _texture, _borderColor, _frame);
+		}
+	}
+}
+
 void Window::DrawChildren(const DrawingContext *dc, float sx, float sy) const
 {
 	NoDestroyHelper(this);
@@ -251,6 +270,7 @@ void Window::Resize(float width, float height)
 	{
 		_width  = width;
 		_height = height;
+		Invalidate();
 		OnSize(width, height);
 		for( Window *w = _firstChild; w; w = w->_nextSibling )
 		{
@@ -307,6 +327,7 @@ void Window::OnEnabledChangeInternal(bool enable, bool inherited)
 void Window::OnVisibleChangeInternal(bool visible, bool inherited)
 {
 	NoDestroyHelper(this);
+	Invalidate();
 	if( visible )
 	{
 		// show children last
@@ -450,6 +471,7 @@ const string_t& Window::GetText() const
 void Window::SetText(const string_t &text)
 {
 	_text.assign(text);
+	Invalidate();
 	OnTextChange();
 }
 
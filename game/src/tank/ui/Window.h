@@ -7,6 +7,8 @@
 #include "core/PtrList.h"
 #include "core/Delegate.h"
 
+#include "video/RenderRecorder.h"
+
 class DrawingContext;
 
 namespace UI
@@ -61,6 +63,10 @@ class Window
 	size_t       _texture;
 	unsigned int _frame;
 
+	mutable RenderRecorder _cache;   // what DrawCached drew, relative to the window
+	mutable bool _isCacheValid;
+	mutable unsigned int _cacheGeneration; // texture manager generation the cache was recorded with
+
 	struct
 	{
 		bool _isVisible      : 1;
@@ -87,7 +93,7 @@ class Window
 protected:
 	unsigned int GetFrameCount() const;
 	unsigned int GetFrame() const { return _frame; }
-	void SetFrame(unsigned int n) { assert(-1 == _texture || n < GetFrameCount()); _frame = n; }
+	void SetFrame(unsigned int n) { assert(-1 == _texture || n < GetFrameCount()); _frame = n; Invalidate(); }
 
 	void OnEnabledChangeInternal(bool enable, bool inherited);
 	void OnVisibleChangeInternal(bool visible, bool inherited);
@@ -114,16 +120,16 @@ public:
 	// Appearance
 	//
 
-	void SetBackColor(SpriteColor color)   { _backColor = color; }
+	void SetBackColor(SpriteColor color)   { _backColor = color; Invalidate(); }
 	SpriteColor GetBackColor() const       { return _backColor;  }
 
-	void SetBorderColor(SpriteColor color) { _borderColor = color; }
+	void SetBorderColor(SpriteColor color) { _borderColor = color; Invalidate(); }
 	SpriteColor GetBorderColor() const     { return _borderColor;  }
 
-	void SetDrawBorder(bool enable)        { _drawBorder = enable; }
+	void SetDrawBorder(bool enable)        { _drawBorder = enable; Invalidate(); }
 	bool GetDrawBorder() const             { return _drawBorder;   }
 
-	void SetDrawBackground(bool enable)    { _drawBackground = enable; }
+	void SetDrawBackground(bool enable)    { _drawBackground = enable; Invalidate(); }
 	bool GetDrawBackground() const         { return _drawBackground;   }
 
 	void SetTexture(const char *tex, bool fitSize);
@@ -183,6 +189,15 @@ public:
 	virtual void Draw(const DrawingContext *dc, float sx = 0, float sy = 0) const;
 	virtual void DrawChildren(const DrawingContext *dc, float sx, float sy) const;
 
+	// makes the next Draw call DrawCached again
+	void Invalidate() { _isCacheValid = false; }
+
+protected:
+	// draws the appearance of the window itself relative to its top left corner.
+	// the result is kept and replayed at the window position until invalidated,
+	// so everything it depends on must call Invalidate when changed
+	virtual void DrawCached(const DrawingContext *dc) const;
+
 private:
 
 	//
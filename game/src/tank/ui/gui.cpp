@@ -67,6 +67,7 @@ NewGameDlg::NewGameDlg(Window *parent, ILevelController *ctrl)
 	_maps->SetTabPos(2, 448); // theme
 	_maps->SetCurSel(_maps->GetData()->FindItem(g_conf.cl_map.Get()), false);
 	_maps->SetScrollPos(_maps->GetCurSel() - (_maps->GetNumLinesVisible() - 1) * 0.5f);
+	SetTimeStep(true); // completes the map list
 
 	GetManager()->SetFocusWnd(_maps);
 
@@ -446,6 +447,14 @@ bool NewGameDlg::OnRawChar(int c)
 	return true;
 }
 
+void NewGameDlg::OnTimeStep(float dt)
+{
+	if( !_maps->GetData()->UpdateIndex() )
+	{
+		SetTimeStep(false);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 EditPlayerDlg::EditPlayerDlg(Window *parent, ConfVarTable *info)
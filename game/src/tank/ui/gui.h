@@ -44,6 +44,7 @@ public:
 	virtual ~NewGameDlg();
 
 	virtual bool OnRawChar(int c);
+	virtual void OnTimeStep(float dt);
 
 protected:
 	void RefreshPlayersList();
@@ -505,6 +505,7 @@ EditorLayout::EditorLayout(Window *parent)
   , _isObjectNew(false)
   , _click(true)
   , _mbutton(0)
+  , _isArea(false)
 {
 	SetTexture(NULL, false);
 
@@ -619,10 +620,34 @@ bool EditorLayout::OnMouseMove(float x, float y)
 	return true;
 }
 
+// clamps the point to the level and aligns it the way the type is placed
+static vec2d SnapToGrid(ObjectType type, const vec2d &mouse)
+{
+	float align = RTTypes::Inst().GetTypeInfo(type).align;
+	float offset = RTTypes::Inst().GetTypeInfo(type).offset;
+
+	vec2d pt;
+	pt.x = __min(g_level->_sx - align, __max(align - offset, mouse.x));
+	pt.y = __min(g_level->_sy - align, __max(align - offset, mouse.y));
+	pt.x -= fmod(pt.x + align * 0.5f - offset, align) - align * 0.5f;
+	pt.y -= fmod(pt.y + align * 0.5f - offset, align) - align * 0.5f;
+	return pt;
+}
+
 bool EditorLayout::OnMouseUp(float x, float y, int button)
 {
 	if( _mbutton == button )
 	{
+		if( _isArea && !_area.empty() )
+		{
+			if( 1 == button )
+				FillArea(_area.front(), _area.back());
+			if( 2 == button )
+				EraseArea(_area);
+		}
+		_isArea = false;
+		_area.clear();
+
 		_click = true;
 		_mbutton = 0;
 		GetManager()->SetCapture(NULL);
@@ -636,6 +661,7 @@ bool EditorLayout::OnMouseDown(float x, float y, int button)
 	{
 		GetManager()->SetCapture(this);
 		_mbutton = button;
+		_isArea = 0 != (GetAsyncKeyState(VK_SHIFT) & 0x8000);
 	}
 
 	if( _mbutton != button )
@@ -644,25 +670,22 @@ bool EditorLayout::OnMouseDown(float x, float y, int button)
 	}
 
 	vec2d mouse;
-	if( GC_Camera::GetWorldMousePos(mouse) )
+	if( _isArea )
+	{
+		// the area is applied when the button is released
+		if( GC_Camera::GetWorldMousePos(mouse) && (_area.empty() || (mouse - _area.back()).sqr() > 16) )
+		{
+			_area.push_back(mouse);
+		}
+	}
+	else if( GC_Camera::GetWorldMousePos(mouse) )
 	{
 		ObjectType type = static_cast<ObjectType>(
 			_typeList->GetData()->GetItemData(g_conf.ed_object.GetInt()) );
 
-		float align = RTTypes::Inst().GetTypeInfo(type).align;
-		float offset = RTTypes::Inst().GetTypeInfo(type).offset;
+		vec2d pt = SnapToGrid(type, mouse);
 
-		vec2d pt;
-		pt.x = __min(g_level->_sx - align, __max(align - offset, mouse.x));
-		pt.y = __min(g_level->_sy - align, __max(align - offset, mouse.y));
-		pt.x -= fmod(pt.x + align * 0.5f - offset, align) - align * 0.5f;
-		pt.y -= fmod(pt.y + align * 0.5f - offset, align) - align * 0.5f;
-
-		int layer = -1;
-		if( g_conf.ed_uselayers.Get() )
-		{
-			layer = RTTypes::Inst().GetTypeInfo(_typeList->GetData()->GetItemData(_typeList->GetCurSel())).layer;
-		}
+		int layer = GetCurrentLayer();
 
 		if( GC_Object *object = g_level->PickEdObject(mouse, layer) )
 		{
@@ -718,6 +741,67 @@ bool EditorLayout::OnMouseDown(float x, float y, int button)
 	return true;
 }
 
+int EditorLayout::GetCurrentLayer() const
+{
+	if( g_conf.ed_uselayers.Get() )
+	{
+		return RTTypes::Inst().GetTypeInfo(_typeList->GetData()->GetItemData(_typeList->GetCurSel())).layer;
+	}
+	return -1;
+}
+
+void EditorLayout::FillArea(const vec2d &p1, const vec2d &p2)
+{
+	ObjectType type = static_cast<ObjectType>(
+		_typeList->GetData()->GetItemData(g_conf.ed_object.GetInt()) );
+	float align = RTTypes::Inst().GetTypeInfo(type).align;
+	int layer = GetCurrentLayer();
+	bool defaults = 0 == (GetAsyncKeyState(VK_CONTROL) & 0x8000);
+
+	vec2d lt = SnapToGrid(type, vec2d(std::min(p1.x, p2.x), std::min(p1.y, p2.y)));
+	vec2d rb = SnapToGrid(type, vec2d(std::max(p1.x, p2.x), std::max(p1.y, p2.y)));
+
+	SelectNone();
+	g_level->BeginBatch();
+	for( float y = lt.y; y < rb.y + align * 0.5f; y += align )
+	{
+		for( float x = lt.x; x < rb.x + align * 0.5f; x += align )
+		{
+			if( !g_level->PickEdObject(vec2d(x, y), layer) )
+			{
+				GC_Object *object = RTTypes::Inst().CreateObject(type, x, y);
+				if( defaults )
+				{
+					SafePtr<PropertySet> properties = object->GetProperties();
+					properties->LoadFromConfig();
+					properties->Exchange(true);
+				}
+			}
+		}
+	}
+	g_level->EndBatch();
+}
+
+void EditorLayout::EraseArea(const std::vector<vec2d> &lasso)
+{
+	std::vector<GC_2dSprite*> found;
+	g_level->PickEdObjects(found, &lasso[0], lasso.size(), GetCurrentLayer());
+
+	// killing an object may kill the objects it owns
+	std::vector<ObjPtr<GC_2dSprite> > objects(found.begin(), found.end());
+
+	SelectNone();
+	g_level->BeginBatch();
+	for( size_t i = 0; i < objects.size(); ++i )
+	{
+		if( objects[i] )
+		{
+			objects[i]->Kill();
+		}
+	}
+	g_level->EndBatch();
+}
+
 bool EditorLayout::OnFocus(bool focus)
 {
 	return true;
@@ -817,6 +901,30 @@ void EditorLayout::DrawChildren(const DrawingContext *dc, float sx, float sy) co
 		dc->DrawSprite(&sel, _selectionRect, 0xffffffff, 0);
 		dc->DrawBorder(&sel, _selectionRect, 0xffffffff, 0);
 	}
+	if( _isArea && !_area.empty() )
+	{
+		const DefaultCamera &cam = g_level->_defaultCamera;
+		if( 1 == _mbutton )
+		{
+			FRECT sel = {
+				(std::min(_area.front().x, _area.back().x) - cam.GetPosX()) * cam.GetZoom(),
+				(std::min(_area.front().y, _area.back().y) - cam.GetPosY()) * cam.GetZoom(),
+				(std::max(_area.front().x, _area.back().x) - cam.GetPosX()) * cam.GetZoom(),
+				(std::max(_area.front().y, _area.back().y) - cam.GetPosY()) * cam.GetZoom()
+			};
+			dc->DrawBorder(&sel, _selectionRect, 0xffffffff, 0);
+		}
+		else
+		{
+			for( size_t i = 0; i < _area.size(); ++i )
+			{
+				float x = (_area[i].x - cam.GetPosX()) * cam.GetZoom();
+				float y = (_area[i].y - cam.GetPosY()) * cam.GetZoom();
+				FRECT dot = { x - 1, y - 1, x + 1, y + 1 };
+				dc->DrawSprite(&dot, _selectionRect, 0xffffffff, 0);
+			}
+		}
+	}
 	vec2d mouse;
 	if( GC_Camera::GetWorldMousePos(mouse) )
 	{
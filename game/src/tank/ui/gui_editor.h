@@ -137,6 +137,9 @@ class EditorLayout : public Window
 	bool _click;
 	int  _mbutton;
 
+	bool _isArea;              // shift was held when the button went down
+	std::vector<vec2d> _area;  // mouse path in world coordinates
+
 
 	void OnKillSelected(GC_Object *sender, void *param);
 	void OnMoveSelected(GC_Object *sender, void *param);
@@ -164,6 +167,10 @@ protected:
 
 	void OnChangeObjectType(int index);
 	void OnChangeUseLayers();
+
+	int GetCurrentLayer() const;
+	void FillArea(const vec2d &p1, const vec2d &p2);
+	void EraseArea(const std::vector<vec2d> &lasso);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
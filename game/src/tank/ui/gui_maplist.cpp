@@ -5,7 +5,7 @@
 #include "gui_maplist.h"
 
 #include "fs/FileSystem.h"
-#include "fs/MapFile.h"
+#include "fs/MapIndex.h"
 
 #include "config/Config.h"
 
@@ -15,42 +15,86 @@ namespace UI
 {
 ///////////////////////////////////////////////////////////////////////////////
 
+static const size_t MAPS_PER_STEP = 16; // keeps the frame time low while the index is rebuilt
+
 ListDataSourceMaps::ListDataSourceMaps()
 {
-	std::set<string_t> files;
-	g_fs->GetFileSystem(DIR_MAPS)->EnumAllFiles(files, TEXT("*.map"));
-	for( std::set<string_t>::iterator it = files.begin(); it != files.end(); ++it )
+	try
+	{
+		// the index goes to the data root, named after the maps directory
+		_index.reset(new MapIndex(g_fs->GetFileSystem(DIR_MAPS), g_fs, DIR_MAPS ".idx"));
+		_index->Refresh();
+	}
+	catch( const std::exception &e )
+	{
+		TRACE("could not list maps - %s", e.what());
+		_index.reset();
+		return;
+	}
+
+	const MapIndex::InfoMap &maps = _index->GetMaps();
+	for( MapIndex::InfoMap::const_iterator it = maps.begin(); it != maps.end(); ++it )
+	{
+		if( it->second.valid || _index->IsStale(it->first) )
+		{
+			SetItemInfo(AddItem(it->first), it->second);
+		}
+	}
+
+	Sort();
+}
+
+ListDataSourceMaps::~ListDataSourceMaps()
+{
+}
+
+void ListDataSourceMaps::SetItemInfo(int index, const MapInfo &info)
+{
+	if( info.valid )
+	{
+		char size[64];
+		wsprintf(size, "%3d*%d", info.width, info.height);
+		SetItemText(index, 1, size);
+		SetItemText(index, 2, info.theme);
+	}
+}
+
+bool ListDataSourceMaps::UpdateIndex()
+{
+	if( !_index )
+	{
+		return false;
+	}
+
+	std::vector<string_t> updated;
+	bool more = _index->Update(MAPS_PER_STEP, &updated);
+
+	for( size_t i = 0; i < updated.size(); ++i )
 	{
-		string_t tmp = DIR_MAPS;
-		tmp += "/";
-		tmp += *it;
+		const MapInfo &info = _index->GetMaps().find(updated[i])->second;
+		int index = FindItem(updated[i]);
+		if( -1 != index )
+		{
+			if( info.valid )
+				SetItemInfo(index, info);
+			else
+				DeleteItem(index);
+		}
+	}
 
+	if( !more )
+	{
 		try
 		{
-			MapFile file(g_fs->Open(tmp)->QueryStream(), false);
-			string_t tmp2 = *it;
-			tmp2.erase(it->length() - 4); // cut out the file extension
-			int index = AddItem(tmp2);
-
-			char size[64];
-			int h = 0, w = 0;
-			file.getMapAttribute("width", w);
-			file.getMapAttribute("height", h);
-			wsprintf(size, "%3d*%d", w, h);
-			SetItemText(index, 1, size);
-
-			if( file.getMapAttribute("theme", tmp) )
-			{
-				SetItemText(index, 2, tmp);
-			}
+			_index->Save();
 		}
 		catch( const std::exception &e )
 		{
-			TRACE("could not open get map attributes - %s", e.what());
+			TRACE("could not save map index - %s", e.what());
 		}
 	}
 
-	Sort();
+	return more;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -4,14 +4,27 @@
 
 #include "List.h"
 
+class MapIndex;
+struct MapInfo;
+
 namespace UI
 {
 ///////////////////////////////////////////////////////////////////////////////
 
+// the list is filled from the map index at once; attributes of new or
+// modified maps arrive later through UpdateIndex
 class ListDataSourceMaps : public ListDataSourceDefault
 {
 public:
 	ListDataSourceMaps();
+	~ListDataSourceMaps();
+
+	// parses a few stale maps; call every frame until it returns false
+	bool UpdateIndex();
+
+private:
+	std::unique_ptr<MapIndex> _index;
+	void SetItemInfo(int index, const MapInfo &info);
 };
 
 
@@ -30,6 +30,7 @@
 #include "network/TankServer.h"
 #include "network/TankClient.h"
 #include "network/LobbyClient.h"
+#include "network/ServerQuery.h"
 
 #include "gc/Player.h"
 #include "gc/ai.h"
@@ -66,6 +67,7 @@ CreateServerDlg::CreateServerDlg(Window *parent)
 	_maps->SetTabPos(2, 448); // theme
 	_maps->SetCurSel(_maps->GetData()->FindItem(g_conf.cl_map.Get()), false);
 	_maps->SetScrollPos(_maps->GetCurSel() - (_maps->GetNumLinesVisible() - 1) * 0.5f);
+	SetTimeStep(true); // completes the map list
 	GetManager()->SetFocusWnd(_maps);
 
 
@@ -139,6 +141,14 @@ CreateServerDlg::~CreateServerDlg()
 {
 }
 
+void CreateServerDlg::OnTimeStep(float dt)
+{
+	if( !_maps->GetData()->UpdateIndex() )
+	{
+		SetTimeStep(false);
+	}
+}
+
 void CreateServerDlg::OnOK()
 {
 	string_t fn;
@@ -328,9 +338,12 @@ void ConnectDlg::OnClientDestroy()
 InternetDlg::InternetDlg(Window *parent)
   : Dialog(parent, 450, 384)
   , _client(new LobbyClient())
+  , _query(new ServerQuery())
 {
 	_client->eventError.bind(&InternetDlg::OnLobbyError, this);
 	_client->eventServerListReply.bind(&InternetDlg::OnLobbyList, this);
+	_query->eventInfo.bind(&InternetDlg::OnServerInfo, this);
+	_query->eventDone.bind(&InternetDlg::OnQueryDone, this);
 
 	PauseGame(true);
 
@@ -347,6 +360,11 @@ InternetDlg::InternetDlg(Window *parent)
 	_servers = DefaultListBox::Create(this);
 	_servers->Move(25, 120);
 	_servers->Resize(400, 180);
+	_servers->SetTabPos(0,   4); // address
+	_servers->SetTabPos(1, 140); // map
+	_servers->SetTabPos(2, 270); // players
+	_servers->SetTabPos(3, 310); // fps
+	_servers->SetTabPos(4, 350); // ping
 	_servers->eventChangeCurSel.bind(&InternetDlg::OnSelectServer, this);
 	_status = Text::Create(_servers, _servers->GetWidth() / 2, _servers->GetHeight() / 2, "", alignTextCC);
 	_status->SetFontColor(0x7f7f7f7f);
@@ -373,6 +391,9 @@ InternetDlg::~InternetDlg()
 
 void InternetDlg::OnRefresh()
 {
+	_query->Cancel();
+	_answered.clear();
+	_silent.clear();
 	_servers->GetData()->DeleteAllItems();
 	_status->SetText(g_lang.net_internet_searching.Get());
 
@@ -411,15 +432,80 @@ void InternetDlg::OnLobbyError(const std::string &msg)
 
 void InternetDlg::OnLobbyList(const std::vector<std::string> &result)
 {
-	_status->SetText(result.empty() ? g_lang.net_internet_not_found.Get() : "");
-	for( size_t i = 0; i < result.size(); ++i )
+	if( result.empty() )
 	{
-		_servers->GetData()->AddItem(result[i]);
+		_status->SetText(g_lang.net_internet_not_found.Get());
+		_btnRefresh->SetEnabled(true);
+		_name->SetEnabled(true);
+		return;
 	}
+
+	// the list stays in lobby order until the servers answer
+	_status->SetText("");
+	_silent = result;
+	UpdateServerList();
+	_query->Probe(result);
+}
+
+void InternetDlg::OnServerInfo(const ServerInfo &info)
+{
+	struct helper
+	{
+		static bool less(const ServerInfo &left, const ServerInfo &right)
+		{
+			// servers running another version can not be joined
+			if( left.compatible != right.compatible )
+				return left.compatible;
+			return left.rtt < right.rtt;
+		}
+	};
+	_answered.insert(std::upper_bound(_answered.begin(), _answered.end(), info, &helper::less), info);
+	_silent.erase(std::find(_silent.begin(), _silent.end(), info.address));
+	UpdateServerList();
+}
+
+void InternetDlg::OnQueryDone()
+{
 	_btnRefresh->SetEnabled(true);
 	_name->SetEnabled(true);
 }
 
+void InternetDlg::UpdateServerList()
+{
+	string_t selected;
+	if( -1 != _servers->GetCurSel() )
+	{
+		selected = _servers->GetData()->GetItemText(_servers->GetCurSel(), 0);
+	}
+
+	ListDataSourceDefault *data = _servers->GetData();
+	data->DeleteAllItems();
+	for( size_t i = 0; i < _answered.size(); ++i )
+	{
+		const ServerInfo &info = _answered[i];
+		std::ostringstream players, fps, ping;
+		players << info.players;
+		fps << info.fps;
+		ping << (int) (info.rtt * 1000);
+
+		int index = data->AddItem(info.address);
+		data->SetItemText(index, 1, info.compatible ? info.map : "(" + info.map + ")");
+		data->SetItemText(index, 2, players.str());
+		data->SetItemText(index, 3, fps.str());
+		data->SetItemText(index, 4, ping.str());
+	}
+	for( size_t i = 0; i < _silent.size(); ++i )
+	{
+		int index = data->AddItem(_silent[i]);
+		data->SetItemText(index, 4, "?");
+	}
+
+	if( !selected.empty() )
+	{
+		_servers->SetCurSel(data->FindItem(selected));
+	}
+}
+
 void InternetDlg::Error(const char *msg)
 {
 	_status->SetText(msg);
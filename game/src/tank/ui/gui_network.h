@@ -8,6 +8,8 @@
 
 // forward declarations
 class LobbyClient;
+class ServerQuery;
+struct ServerInfo;
 
 namespace UI
 {
@@ -37,6 +39,8 @@ public:
 	CreateServerDlg(Window *parent);
 	virtual ~CreateServerDlg();
 
+	virtual void OnTimeStep(float dt);
+
 protected:
 	void OnOK();
 	void OnCancel();
@@ -98,9 +102,16 @@ protected:
 	void OnLobbyError(const std::string &msg);
 	void OnLobbyList(const std::vector<std::string> &result);
 
+	void OnServerInfo(const ServerInfo &info);
+	void OnQueryDone();
+	void UpdateServerList();
+
 	void Error(const char *msg);
 
 	SafePtr<LobbyClient> _client;
+	SafePtr<ServerQuery> _query;
+	std::vector<ServerInfo> _answered;  // compatible first, then by rtt
+	std::vector<std::string> _silent;   // not answered yet
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -62,9 +62,10 @@ void FpsCounter::OnTimeStep(float dt)
 			-1
 		);
 
-		wsprintf(s1, "; obj:%d\ntimestep: %4d",
+		wsprintf(s1, "; obj:%d\ntimestep: %4d active, %4d sleeping",
 			g_level->GetList(LIST_objects).size(), 
-			g_level->ts_fixed.size()
+			g_level->ts_fixed.size() - g_level->ts_fixed.GetSleepingCount(),
+			g_level->ts_fixed.GetSleepingCount()
 		);
 		strcat(s, s1);
 
@@ -0,0 +1,235 @@
+// RenderRecorder.cpp
+
+#include "stdafx.h"
+
+#include "RenderRecorder.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderRecorder::RenderRecorder()
+  : _target(NULL)
+{
+}
+
+void RenderRecorder::Begin(IRender *target)
+{
+	assert(target && target != this);
+	_target = target;
+	_commands.clear();
+	_vertices.clear();
+	_lines.clear();
+}
+
+static void Translate(MyVertex *v, size_t count, float dx, float dy)
+{
+	for( size_t i = 0; i < count; ++i )
+	{
+		v[i].x += dx;
+		v[i].y += dy;
+	}
+}
+
+void RenderRecorder::Replay(const FRECT *bounds, float dx, float dy) const
+{
+	assert(_target);
+
+	for( std::vector<Command>::const_iterator it = _commands.begin(); it != _commands.end(); ++it )
+	{
+		switch( it->type )
+		{
+		case CMD_MODE:
+			_target->SetMode(it->mode);
+			break;
+		case CMD_QUADS:
+			for( size_t i = 0; i < it->count; ++i )
+			{
+				const MyVertex *src = &_vertices[it->first + i * 4];
+				if( bounds )
+				{
+					float xmin = std::min(std::min(src[0].x, src[1].x), std::min(src[2].x, src[3].x)) + dx;
+					float xmax = std::max(std::max(src[0].x, src[1].x), std::max(src[2].x, src[3].x)) + dx;
+					float ymin = std::min(std::min(src[0].y, src[1].y), std::min(src[2].y, src[3].y)) + dy;
+					float ymax = std::max(std::max(src[0].y, src[1].y), std::max(src[2].y, src[3].y)) + dy;
+					if( xmax <= bounds->left || xmin >= bounds->right || ymax <= bounds->top || ymin >= bounds->bottom )
+					{
+						continue;
+					}
+				}
+				MyVertex *dst = _target->DrawQuad(it->tex);
+				memcpy(dst, src, sizeof(MyVertex) * 4);
+				if( dx || dy )
+				{
+					Translate(dst, 4, dx, dy);
+				}
+			}
+			break;
+		case CMD_FAN:
+		{
+			MyVertex *dst = _target->DrawFan(it->count);
+			memcpy(dst, &_vertices[it->first], sizeof(MyVertex) * (it->count + 1));
+			if( dx || dy )
+			{
+				Translate(dst, it->count + 1, dx, dy);
+			}
+			break;
+		}
+		case CMD_LINES:
+			if( dx || dy )
+			{
+				for( size_t i = 0; i < it->count; ++i )
+				{
+					MyLine line = _lines[it->first + i];
+					line.begin += vec2d(dx, dy);
+					line.end += vec2d(dx, dy);
+					_target->DrawLines(&line, 1);
+				}
+			}
+			else
+			{
+				_target->DrawLines(&_lines[it->first], it->count);
+			}
+			break;
+		default:
+			assert(false);
+		}
+	}
+}
+
+bool RenderRecorder::Init(HWND hWnd, const DisplayMode *pMode, bool bFullScreen)
+{
+	assert(false); // the recorder does not own a device
+	return false;
+}
+
+void RenderRecorder::Release()
+{
+	assert(false); // the recorder does not own a device
+}
+
+bool RenderRecorder::getDisplayMode(int index, DisplayMode *pMode) const
+{
+	return _target->getDisplayMode(index, pMode);
+}
+
+int RenderRecorder::getModeCount() const
+{
+	return _target->getModeCount();
+}
+
+void RenderRecorder::OnResizeWnd()
+{
+	_target->OnResizeWnd();
+}
+
+void RenderRecorder::SetScissor(const RECT *rect)
+{
+	_target->SetScissor(rect);
+}
+
+void RenderRecorder::SetViewport(const RECT *rect)
+{
+	_target->SetViewport(rect);
+}
+
+void RenderRecorder::Camera(const RECT *vp, float x, float y, float scale, float angle)
+{
+	_target->Camera(vp, x, y, scale, angle);
+}
+
+int RenderRecorder::GetWidth() const
+{
+	return _target->GetWidth();
+}
+
+int RenderRecorder::GetHeight() const
+{
+	return _target->GetHeight();
+}
+
+int RenderRecorder::GetViewportWidth() const
+{
+	return _target->GetViewportWidth();
+}
+
+int RenderRecorder::GetViewportHeight() const
+{
+	return _target->GetViewportHeight();
+}
+
+void RenderRecorder::SetMode(const RenderMode mode)
+{
+	Command cmd;
+	cmd.type = CMD_MODE;
+	cmd.mode = mode;
+	_commands.push_back(cmd);
+}
+
+void RenderRecorder::Begin()
+{
+	_target->Begin();
+}
+
+void RenderRecorder::End()
+{
+	_target->End();
+}
+
+void RenderRecorder::SetAmbient(float ambient)
+{
+	_target->SetAmbient(ambient);
+}
+
+bool RenderRecorder::TakeScreenshot(TCHAR *fileName)
+{
+	return _target->TakeScreenshot(fileName);
+}
+
+bool RenderRecorder::TexCreate(DEV_TEXTURE &tex, Image *img)
+{
+	return _target->TexCreate(tex, img);
+}
+
+void RenderRecorder::TexFree(DEV_TEXTURE tex)
+{
+	_target->TexFree(tex);
+}
+
+MyVertex* RenderRecorder::DrawQuad(DEV_TEXTURE tex)
+{
+	if( _commands.empty() || CMD_QUADS != _commands.back().type || !(_commands.back().tex == tex) )
+	{
+		Command cmd;
+		cmd.type = CMD_QUADS;
+		cmd.tex = tex;
+		cmd.first = _vertices.size();
+		cmd.count = 0;
+		_commands.push_back(cmd);
+	}
+	++_commands.back().count;
+	_vertices.resize(_vertices.size() + 4);
+	return &_vertices[_vertices.size() - 4];
+}
+
+MyVertex* RenderRecorder::DrawFan(size_t nEdges)
+{
+	Command cmd;
+	cmd.type = CMD_FAN;
+	cmd.first = _vertices.size();
+	cmd.count = nEdges;
+	_commands.push_back(cmd);
+	_vertices.resize(_vertices.size() + nEdges + 1);
+	return &_vertices[cmd.first];
+}
+
+void RenderRecorder::DrawLines(const MyLine *lines, size_t count)
+{
+	Command cmd;
+	cmd.type = CMD_LINES;
+	cmd.first = _lines.size();
+	cmd.count = count;
+	_commands.push_back(cmd);
+	_lines.insert(_lines.end(), lines, lines + count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
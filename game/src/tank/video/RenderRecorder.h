@@ -0,0 +1,85 @@
+// RenderRecorder.h
+
+#pragma once
+
+#include "RenderBase.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// stores primitives in world space so one pass over the level can be drawn
+// into several viewports. SetMode and the drawing calls are recorded; all
+// other calls go straight to the target renderer.
+
+class RenderRecorder : public IRender
+{
+public:
+	RenderRecorder();
+
+	// drops the previous recording; target is used for texture management
+	// and queries while recording and receives the replayed primitives
+	void Begin(IRender *target);
+
+	// draws the recording with the current camera of the target, shifted by
+	// (dx, dy). if bounds are given, quads lying entirely outside them are skipped
+	void Replay(const FRECT *bounds, float dx = 0, float dy = 0) const;
+
+	// IRender
+	virtual bool Init(HWND hWnd, const DisplayMode *pMode, bool bFullScreen);
+	virtual void Release();
+
+	virtual bool getDisplayMode(int index, DisplayMode *pMode) const;
+	virtual int  getModeCount() const;
+
+	virtual void OnResizeWnd();
+
+	virtual void SetScissor(const RECT *rect);
+	virtual void SetViewport(const RECT *rect);
+	virtual void Camera(const RECT *vp, float x, float y, float scale, float angle);
+
+	virtual int  GetWidth() const;
+	virtual int  GetHeight() const;
+
+	virtual int  GetViewportWidth() const;
+	virtual int  GetViewportHeight() const;
+
+	virtual void SetMode (const RenderMode mode);
+	virtual void Begin   (void);
+	virtual void End     (void);
+
+	virtual void SetAmbient(float ambient);
+
+	virtual bool TakeScreenshot(TCHAR *fileName);
+
+	virtual bool TexCreate(DEV_TEXTURE &tex, Image *img);
+	virtual void TexFree(DEV_TEXTURE tex);
+
+	virtual MyVertex* DrawQuad(DEV_TEXTURE tex);
+	virtual MyVertex* DrawFan(size_t nEdges);
+
+	virtual void DrawLines(const MyLine *lines, size_t count);
+
+private:
+	enum CommandType
+	{
+		CMD_MODE,
+		CMD_QUADS,  // consecutive quads sharing the texture
+		CMD_FAN,
+		CMD_LINES,
+	};
+
+	struct Command
+	{
+		CommandType  type;
+		RenderMode   mode;
+		DEV_TEXTURE  tex;
+		size_t       first;  // index in _vertices or _lines
+		size_t       count;  // number of quads, fan edges or lines
+	};
+
+	IRender *_target;
+	std::vector<Command>  _commands;
+	std::vector<MyVertex> _vertices;
+	std::vector<MyLine>   _lines;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// end of file
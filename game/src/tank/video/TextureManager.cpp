@@ -38,8 +38,10 @@ const unsigned char CheckerImage::_bytes[] = {
 ///////////////////////////////////////////////////////////////////////////////
 
 TextureManager::TextureManager()
+  : _generation(0)
 {
 	memset(&_viewport, 0, sizeof(_viewport));
+	ClearGlyphRuns();
 	CreateChecker();
 }
 
@@ -58,6 +60,8 @@ void TextureManager::UnloadAllTextures()
 	_mapDevTex_to_TexDescIter.clear();
 	_mapName_to_Index.clear();
 	_logicalTextures.clear();
+	ClearGlyphRuns();
+	++_generation;
 }
 
 void TextureManager::LoadTexture(TexDescIterator &itTexDesc, const string_t &fileName)
@@ -190,6 +194,8 @@ static float auxgetfloat(lua_State *L, int tblidx, const char *field, float def)
 int TextureManager::LoadPackage(const string_t &packageName, const SafePtr<FS::MemMap> &file)
 {
 	TRACE("Loading texture package '%s'", packageName.c_str());
+	ClearGlyphRuns(); // font metrics may change
+	++_generation;
 
 	lua_State *L = lua_open();
 
@@ -357,6 +363,8 @@ int TextureManager::LoadPackage(const string_t &packageName, const SafePtr<FS::M
 int TextureManager::LoadDirectory(const string_t &dirName, const string_t &texPrefix)
 {
 	int count = 0;
+	ClearGlyphRuns(); // font metrics may change
+	++_generation;
 
 	SafePtr<FS::FileSystem> dir = g_fs->GetFileSystem(dirName);
 
@@ -644,13 +652,82 @@ void TextureManager::DrawBorder(const FRECT *dst, size_t sprite, SpriteColor col
 	v[3].y = dst->bottom + pxBorderSize;
 }
 
-void TextureManager::DrawBitmapText(float sx, float sy, size_t tex, SpriteColor color, const string_t &str, enumAlignText align) const
+void TextureManager::ClearGlyphRuns()
+{
+	_glyphRuns.clear();
+	for( int i = 0; i < GLYPH_RUN_BUCKETS; ++i )
+	{
+		_glyphRunBuckets[i] = -1;
+	}
+	_glyphRunClock = 0;
+}
+
+const TextureManager::GlyphRun& TextureManager::GetGlyphRun(size_t tex, const string_t &str, enumAlignText align) const
 {
+	unsigned int hash = 2166136261U; // FNV-1a
+	hash = (hash ^ (unsigned int) tex) * 16777619U;
+	hash = (hash ^ (unsigned int) align) * 16777619U;
+	for( const string_t::value_type *tmp = str.c_str(); *tmp; ++tmp )
+	{
+		hash = (hash ^ (unsigned char) *tmp) * 16777619U;
+	}
+
+	for( int i = _glyphRunBuckets[hash % GLYPH_RUN_BUCKETS]; -1 != i; i = _glyphRuns[i].next )
+	{
+		GlyphRun &run = _glyphRuns[i];
+		if( run.hash == hash && run.tex == tex && run.align == align && run.text == str )
+		{
+			run.lastUse = ++_glyphRunClock;
+			return run;
+		}
+	}
+
+
+	//
+	// take a free run or the least recently used one
+	//
+
+	int index;
+	if( _glyphRuns.size() < GLYPH_RUN_COUNT )
+	{
+		index = (int) _glyphRuns.size();
+		_glyphRuns.push_back(GlyphRun());
+	}
+	else
+	{
+		index = 0;
+		for( int i = 1; i < GLYPH_RUN_COUNT; ++i )
+		{
+			if( _glyphRuns[i].lastUse < _glyphRuns[index].lastUse )
+				index = i;
+		}
+		int *link = &_glyphRunBuckets[_glyphRuns[index].hash % GLYPH_RUN_BUCKETS];
+		while( *link != index )
+		{
+			link = &_glyphRuns[*link].next;
+		}
+		*link = _glyphRuns[index].next;
+	}
+
+	GlyphRun &run = _glyphRuns[index];
+	run.tex = tex;
+	run.align = align;
+	run.text = str;
+	run.hash = hash;
+	run.lastUse = ++_glyphRunClock;
+	run.next = _glyphRunBuckets[hash % GLYPH_RUN_BUCKETS];
+	_glyphRunBuckets[hash % GLYPH_RUN_BUCKETS] = index;
+
+
+	//
+	// layout
+	//
+
 	// grep enum enumAlignText LT CT RT LC CC RC LB CB RB
 	static const float dx[] = { 0, 1, 2, 0, 1, 2, 0, 1, 2 };
 	static const float dy[] = { 0, 0, 0, 1, 1, 1, 2, 2, 2 };
 
-	std::vector<size_t> lines;
+	size_t lineCount = 0;
 	size_t maxline = 0;
 	if( align )
 	{
@@ -663,7 +740,7 @@ void TextureManager::DrawBitmapText(float sx, float sy, size_t tex, SpriteColor
 			{
 				if( maxline < count ) 
 					maxline = count;
-				lines.push_back(count);
+				++lineCount;
 				count = 0;
 			}
 		}
@@ -675,9 +752,10 @@ void TextureManager::DrawBitmapText(float sx, float sy, size_t tex, SpriteColor
 	size_t count = 0;
 	size_t line  = 0;
 
-	float x0 = sx - floorf(dx[align] * (lt.pxFrameWidth - 1) * (float) maxline / 2);
-	float y0 = sy - floorf(dy[align] * lt.pxFrameHeight * (float) lines.size() / 2);
+	float x0 = -floorf(dx[align] * (lt.pxFrameWidth - 1) * (float) maxline / 2);
+	float y0 = -floorf(dy[align] * lt.pxFrameHeight * (float) lineCount / 2);
 
+	run.vertices.clear();
 	for( const string_t::value_type *tmp = str.c_str(); *tmp; ++tmp )
 	{
 		if( '\n' == *tmp )
@@ -695,32 +773,49 @@ void TextureManager::DrawBitmapText(float sx, float sy, size_t tex, SpriteColor
 		float x = x0 + (float) ((count++) * (lt.pxFrameWidth - 1));
 		float y = y0 + (float) (line * lt.pxFrameHeight);
 
-		MyVertex *v = g_render->DrawQuad(lt.dev_texture);
+		run.vertices.resize(run.vertices.size() + 4);
+		MyVertex *v = &*(run.vertices.end() - 4);
 
-		v[0].color = color;
 		v[0].u = rt.left;
 		v[0].v = rt.top;
 		v[0].x = x;
 		v[0].y = y ;
 
-		v[1].color = color;
 		v[1].u = rt.left + lt.uvFrameWidth;
 		v[1].v = rt.top;
 		v[1].x = x + lt.pxFrameWidth;
 		v[1].y = y;
 
-		v[2].color = color;
 		v[2].u = rt.left + lt.uvFrameWidth;
 		v[2].v = rt.bottom;
 		v[2].x = x + lt.pxFrameWidth;
 		v[2].y = y + lt.pxFrameHeight;
 
-		v[3].color = color;
 		v[3].u = rt.left;
 		v[3].v = rt.bottom;
 		v[3].x = x;
 		v[3].y = y + lt.pxFrameHeight;
 	}
+
+	return run;
+}
+
+void TextureManager::DrawBitmapText(float sx, float sy, size_t tex, SpriteColor color, const string_t &str, enumAlignText align) const
+{
+	const GlyphRun &run = GetGlyphRun(tex, str, align);
+	const LogicalTexture &lt = Get(tex);
+
+	for( size_t i = 0; i < run.vertices.size(); i += 4 )
+	{
+		MyVertex *v = g_render->DrawQuad(lt.dev_texture);
+		for( int j = 0; j < 4; ++j )
+		{
+			v[j] = run.vertices[i + j];
+			v[j].color = color;
+			v[j].x += sx;
+			v[j].y += sy;
+		}
+	}
 }
 
 void TextureManager::DrawSprite(size_t tex, unsigned int frame, SpriteColor color, float x, float y, vec2d dir) const
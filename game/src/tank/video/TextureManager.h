@@ -39,6 +39,10 @@ public:
 	int LoadDirectory(const string_t &dirName, const string_t &texPrefix);
 	void UnloadAllTextures();
 
+	// changes whenever textures are loaded or unloaded; draw lists recorded
+	// with an older generation may refer to textures which no longer exist
+	unsigned int GetGeneration() const { return _generation; }
+
 	size_t FindSprite(const string_t &name) const;
 	const LogicalTexture& Get(size_t texIndex) const { return _logicalTextures[texIndex]; }
 	float GetFrameWidth(size_t texIndex, size_t /*frameIdx*/) const { return _logicalTextures[texIndex].pxFrameWidth; }
@@ -85,6 +89,32 @@ private:
 
 	RECT _viewport;
 	mutable std::stack<RECT> _clipStack;
+	unsigned int _generation;
+
+	// glyph quads of recently drawn strings laid out at the origin. the runs
+	// are chained in hash buckets and the least recently used one is reused
+	// when the cache is full, so drawing a cached string does not allocate
+	struct GlyphRun
+	{
+		size_t        tex;
+		enumAlignText align;
+		string_t      text;
+		unsigned int  hash;
+		unsigned int  lastUse;
+		int           next;      // next run in the bucket or -1
+		std::vector<MyVertex> vertices; // 4 per glyph; color is not set
+	};
+	enum
+	{
+		GLYPH_RUN_COUNT   = 256,
+		GLYPH_RUN_BUCKETS = 512,
+	};
+	mutable std::vector<GlyphRun> _glyphRuns;
+	mutable int                   _glyphRunBuckets[GLYPH_RUN_BUCKETS];
+	mutable unsigned int          _glyphRunClock;
+
+	const GlyphRun& GetGlyphRun(size_t tex, const string_t &str, enumAlignText align) const;
+	void ClearGlyphRuns();
 
 	void LoadTexture(TexDescIterator &itTexDesc, const string_t &fileName);
 	void Unload(TexDescIterator what);
@@ -3,6 +3,7 @@
 # reg/unreg=ipv4
 # key=unique key
 # ver=current version
+# gen=generation of the server list known to the client
 #
 # if version does not match, server prints required version
 
@@ -13,20 +14,119 @@ use warnings;
 
 use CGI qw(:standard);
 use CGI::Carp qw(fatalsToBrowser);
+use Fcntl qw(:flock :seek);
 
 
-my $dbfile = './data/servers.db';
-my $idfile = './data/servers.id';
-my $maxrecords = 100;
+# every server has a record file named after its address; a heartbeat only
+# updates the file time. additions and removals are numbered in the log so
+# clients can ask for the changes since the generation they have seen.
+my $recdir = './data/servers';
+my $logfile = './data/servers.log';
+my $sweepfile = './data/servers.sweep';
+my $maxrecords = 5000;
+my $maxlog = 10000;      # log entries kept before it starts over
 my $timeout = 60;
+my $sweepinterval = 10;  # seconds between removals of timed out servers
 my $version = '149b';
 
 
-sub escape_chr($)
+sub recfile($)
 {
-	my ($letter) = (@_);
-	my %table  = ( 'n'=>"\n", 't'=>"\t" );
-	return exists $table{$letter} ? $table{$letter} : $letter;
+	my ($addr) = (@_);
+	$addr =~ tr/:/_/;
+	return "$recdir/$addr";
+}
+
+sub listrecords()
+{
+	opendir(RECDIR, $recdir) or die "couldn't open record directory: $!";
+	my @result = grep { !/^\./ } readdir(RECDIR);
+	closedir(RECDIR);
+	tr/_/:/ foreach @result;
+	return @result;
+}
+
+sub checkkey($$)
+{
+	my ($file, $key) = (@_);
+	open REC, "< $file" or die "couldn't open record: $!";
+	my $line = <REC>;
+	close REC;
+	if( not defined $line or $line ne "key=$key\n" )
+	{
+		print "wrong key\n";
+		exit;
+	}
+}
+
+# opens the log locked in the given mode; the first line is "epoch base"
+sub openlog($)
+{
+	my ($mode) = (@_);
+	mkdir $recdir unless( -d $recdir );
+	open LOG, "+>> $logfile" or die "couldn't open log: $!";
+	flock(LOG, $mode) or die "could not lock log: $!";
+	if( not -s LOG )
+	{
+		flock(LOG, LOCK_EX) or die "could not lock log: $!";
+		print LOG time(), " 0\n" if( not -s LOG );
+		flock(LOG, $mode) or die "could not lock log: $!";
+	}
+	select((select(LOG), $| = 1)[0]); # autoflush
+}
+
+sub readlog()
+{
+	seek(LOG, 0, SEEK_SET) or die "cant seek log: $!";
+	my ($epoch, $base) = split(' ', <LOG>);
+	my %state = ( 'epoch' => $epoch, 'base' => $base, 'gen' => $base, 'entries' => [] );
+	while( <LOG> )
+	{
+		next unless( /^(\d+) ([+-]) (\S+)$/ );
+		push @{$state{'entries'}}, [$1, $2, $3];
+		$state{'gen'} = $1;
+	}
+	return \%state;
+}
+
+sub addentry($$$)
+{
+	my ($state, $op, $addr) = (@_);
+	if( @{$state->{'entries'}} >= $maxlog )
+	{
+		# clients older than the new base will get the full list
+		truncate(LOG, 0) or die "cant truncate log: $!";
+		print LOG "$state->{'epoch'} $state->{'gen'}\n";
+		$state->{'base'} = $state->{'gen'};
+		$state->{'entries'} = [];
+	}
+	$state->{'gen'}++;
+	seek(LOG, 0, SEEK_END) or die "cant seek log: $!";
+	print LOG "$state->{'gen'} $op $addr\n" or die "cant write log: $!";
+	push @{$state->{'entries'}}, [$state->{'gen'}, $op, $addr];
+}
+
+# removes servers that have timed out; the log must be locked exclusively
+sub sweep($)
+{
+	my ($state) = (@_);
+	foreach my $addr (listrecords())
+	{
+		my $file = recfile($addr);
+		my $updated = (stat $file)[9];
+		if( defined $updated and time() - $updated > $timeout and unlink $file )
+		{
+			addentry($state, '-', $addr);
+		}
+	}
+	open SWEEP, "> $sweepfile" or die "couldn't open $sweepfile: $!";
+	close SWEEP;
+}
+
+sub sweepdue()
+{
+	my $swept = (stat $sweepfile)[9];
+	return !defined($swept) || time() - $swept >= $sweepinterval;
 }
 
 sub addrefresh($$$)
@@ -51,109 +151,63 @@ sub addrefresh($$$)
 		print "invalid key";
 		exit;
 	}
+
+	my $file = recfile($addr);
 	
 
 	#
-	# load the data base and store it in array of hashes
+	# refresh of a live server touches its record and nothing else
 	#
 
-	my %db = ();
-	my $dbsize = 0;
-	my $found = 0;
-
-	open DB, "+< $dbfile" or die "couldn't open database: $!";
-	flock(DB, 2); # exclusive lock
-	while( <DB> )
+	openlog(LOCK_SH);
+	my $updated = (stat $file)[9];
+	if( $reg and defined $updated and time() - $updated <= $timeout )
 	{
-		next unless( /^\s*(\d+): / );
-		my $id = $1;
-		my %current = ();
-		while( /([a-z_][a-z_0-9]*)="(([^\"\\]|\\.)*)"/gi ) # detect fields with escape characters
-		{
-			my ($key, $value) = ($1, $2);
-			$value =~ s/\\(.)/escape_chr($1)/ge; # expand escape characters
-			$current{$key} = $value;
-		}
-		
-		# skip records which are empty or out of date
-		next if( time() - $current{'updated'} > $timeout or not %current );
-		
-		# refresh record if key and addr match
-		if( $current{'addr'} eq $addr )
-		{
-			$found = 1;
-			if( $current{'key'} eq $key )
-			{
-				if( $reg )
-				{
-					$current{'updated'} = time();
-				}
-				else
-				{
-					next; # unregisted server
-				}
-			}
-			else
-			{
-				print "wrong key\n";
-				exit;
-			}
-		}
-
-		# add to database
-		$dbsize++;
-		$db{$id} = \%current;
+		checkkey($file, $key);
+		utime(undef, undef, $file) or die "cant update record: $!";
+		print "ok";
+		close LOG;
+		return;
 	}
-	
-	# add new record if it does not exist
-	if( $reg and not $found )
+
+
+	#
+	# additions and removals go to the log
+	#
+
+	flock(LOG, LOCK_EX) or die "could not lock log: $!";
+	my $state = readlog();
+	sweep($state);
+
+	if( -e $file )
 	{
-		if( $dbsize < $maxrecords )
+		checkkey($file, $key);
+		if( $reg )
 		{
-			# generate new id
-			my $newid;
-			open IDFILE, "+< $idfile" or die "could not open id file: $!";
-			flock(IDFILE, 2) or die "could not lock id file: $!";
-			$newid = <IDFILE>;
-			$newid =~ s/\D//g;  # strip non-digits
-			$newid = 1 if(not $newid);
-			seek(IDFILE, 0, 0) or die "cant seek id file: $!";
-			truncate(IDFILE, 0);
-			print IDFILE ($newid+1) or die "cant write new id value: $!";
-			close IDFILE or die "cant close id file: $!";
-			
-			# add record
-			$dbsize++;
-			$db{$newid} = 
-			{
-				'created' => time(),
-				'updated' => time(),
-				'addr'    => $addr,
-				'key'     => $key,
-			};
+			utime(undef, undef, $file) or die "cant update record: $!";
 		}
 		else
 		{
-			print "limit exceeds";
+			unlink $file or die "cant remove record: $!";
+			addentry($state, '-', $addr);
 		}
 	}
-	
-	# write file
-	seek(DB, 0, 0) or die "cant seek db file: $!";
-	truncate(DB, 0) or die "cant truncate db file: $!";;
-	foreach my $id (keys %db)
+	elsif( $reg )
 	{
-		my $current = $db{$id};
-		print DB "$id: ";
-		foreach( keys %$current )
+		if( scalar(listrecords()) >= $maxrecords )
 		{
-			print DB "$_=\"$current->{$_}\" ";
+			print "limit exceeds";
+			close LOG;
+			exit;
 		}
-		print DB "\n";
+		open REC, "> $file" or die "couldn't create record: $!";
+		print REC "key=$key\n";
+		close REC or die "cant write record: $!";
+		addentry($state, '+', $addr);
 	}
 
 	print "ok";
-	close DB;
+	close LOG;
 }
 
 
@@ -190,30 +244,51 @@ if( param('unreg') and param('key') )
 
 
 #
-# load and print data base
+# print server list
 #
 
 print "Content-type: text/plain\n\n";
 
-open DB, "< $dbfile" or die "couldn't open database: $!";
-flock(DB, 1); # non-exclusive lock
-while( <DB> )
+openlog(LOCK_SH);
+if( sweepdue() )
 {
-	next unless( /^\s*(\d+): / );
-	my $id = $1;
-	my %current = ();
-	while( /([a-z_][a-z_0-9]*)="(([^\"\\]|\\.)*)"/gi ) # detect fields with escape characters
-	{
-		my ($key, $value) = ($1, $2);
-		$value =~ s/\\(.)/escape_chr($1)/ge; # expand escape characters
-		$current{$key} = $value;
-	}
-	if( %current and time() - $current{'updated'} <= $timeout )
+	flock(LOG, LOCK_EX) or die "could not lock log: $!";
+	sweep(readlog()) if( sweepdue() );
+	flock(LOG, LOCK_SH) or die "could not lock log: $!";
+}
+
+# clients without gen get the plain list
+if( not defined param('gen') )
+{
+	print "$_\n" foreach listrecords();
+	close LOG;
+	print "end\n";
+	exit;
+}
+
+# gen=<epoch>:<generation> as returned by the previous request; the reply is
+#   gen <epoch>:<generation>
+#   full            - the client should forget its list
+#   + <address>
+#   - <address>
+#   end
+my $state = readlog();
+my ($epoch, $gen) = split(/:/, param('gen'));
+print "gen $state->{'epoch'}:$state->{'gen'}\n";
+if( defined $gen and $gen =~ /^\d+$/ and $epoch eq $state->{'epoch'} and
+    $gen >= $state->{'base'} and $gen <= $state->{'gen'} )
+{
+	foreach( @{$state->{'entries'}} )
 	{
-		print $current{addr}, "\n";
+		print "$_->[1] $_->[2]\n" if( $_->[0] > $gen );
 	}
 }
-close DB;
+else
+{
+	print "full\n";
+	print "+ $_\n" foreach listrecords();
+}
+close LOG;
 
 print "end\n"
 
@@ -1,95 +1,101 @@
 // mapinfo.cpp : Defines the entry point for the console application.
 //
 
-#include "../Tank/SaveFile.h"
+#include "stdafx.h"
 
+#include "fs/FileSystem.h"
+#include "fs/MapFile.h"
+#include "fs/MapIndex.h"
 
 #include <iostream>
-#include <algorithm>
+#include <stdarg.h>
 
 using namespace std;
 
-void replace(string &str, const char *what, const char *by)
+void ToolConsole::Printf(int severity, const char *fmt, ...)
 {
-	string::size_type pos = 0;
-	size_t lw = strlen(what);
-	size_t lb = strlen(by);
-
-	while( pos < str.length() )
-	{
-		pos = str.find(what, pos);
-		if( string::npos == pos )
-			return;
-		str.replace(pos, lw, by);
-		pos += lb;
-	}
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
 }
 
-void escape(string &str)
+ToolConsole& GetConsole()
 {
-	replace(str, "\r", "");
-	replace(str, "\\", "\\\\");
-	replace(str, "\n", "\\n");
-	replace(str, "\t", "\\t");
-	replace(str, "\"", "\\\"");
+	static ToolConsole console;
+	return console;
 }
 
-int main(int argc, char* argv[])
+string_t StrFromErr(DWORD dwMessageId)
 {
-	if( argc < 2 )
-	{
-		cout << "usage: mapinfo <map_file>" << endl;
-		return 0;
-	}
-
-	MapFile file;
-	if( !file.Open(argv[1], false) )
-	{
-		cerr << "couldn't open map file" << endl;
-		return -1;
-	}
+	LPVOID lpMsgBuf = NULL;
+	FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
+		NULL, dwMessageId, 0, (LPTSTR) &lpMsgBuf, 0, NULL);
+	string_t result((LPCTSTR) lpMsgBuf);
+	LocalFree(lpMsgBuf);
+	return result;
+}
 
-	string val;
+// prints attributes of every map in the directory and updates its index
+int PrintIndex(const char *dir)
+{
+	SafePtr<FS::FileSystem> fs = FS::OSFileSystem::Create(dir);
+	MapIndex index(fs, fs, "maps.idx"); // a loose directory can hold its own index
+	index.Refresh();
+	index.Update(-1);
 
-	if( file.getMapAttribute("author", val) )
+	const MapIndex::InfoMap &maps = index.GetMaps();
+	for( MapIndex::InfoMap::const_iterator it = maps.begin(); it != maps.end(); ++it )
 	{
-		escape(val);
-		cout << "author=\"" << val << "\" ";
+		if( it->second.valid )
+		{
+			cout << "name=\"" << it->first << "\" " << it->second.Format() << endl;
+		}
 	}
+	return 0;
+}
 
-	if( file.getMapAttribute("e-mail", val) )
+int main(int argc, char* argv[])
+{
+	if( argc == 3 && 0 == strcmp(argv[1], "-index") )
 	{
-		escape(val);
-		cout << "email=\"" << val << "\" ";
+		try
+		{
+			return PrintIndex(argv[2]);
+		}
+		catch( const std::exception &e )
+		{
+			cerr << e.what() << endl;
+			return -1;
+		}
 	}
 
-	if( file.getMapAttribute("link-url", val) )
+	if( argc < 2 )
 	{
-		escape(val);
-		cout << "url=\"" << val << "\" ";
+		cout << "usage: mapinfo <map_file>" << endl;
+		cout << "       mapinfo -index <map_directory>" << endl;
+		return 0;
 	}
 
-	if( file.getMapAttribute("desc", val) )
-	{
-		escape(val);
-		cout << "desc=\"" << val << "\" ";
-	}
+	string path = argv[1];
+	string::size_type slash = path.find_last_of("/\\");
+	string dir = string::npos == slash ? "." : path.substr(0, slash);
+	string name = string::npos == slash ? path : path.substr(slash + 1);
 
-	if( file.getMapAttribute("theme", val) )
+	MapInfo info;
+	try
 	{
-		escape(val);
-		cout << "theme=\"" << val << "\" ";
+		MapFile file(FS::OSFileSystem::Create(dir)->Open(name)->QueryStream(), false);
+		info.ReadFrom(file);
 	}
-
-	int x, y;
-	if( file.getMapAttribute("width", x) && file.getMapAttribute("height", y) )
+	catch( const std::exception &e )
 	{
-		stringstream ss;
-		ss << x << "x" << y;
-		cout << "mapsize=\"" << ss.str() << "\" ";
+		cerr << "couldn't open map file: " << e.what() << endl;
+		return -1;
 	}
 
-
+	cout << info.Format();
 	return 0;
 }
 
@@ -6,7 +6,27 @@
 #pragma once
 
 #define WIN32_LEAN_AND_MEAN		// Exclude rarely-used stuff from Windows headers
+#include <windows.h>
 #include <stdio.h>
 #include <tchar.h>
 
-// TODO: reference additional headers your program requires here
+#include <cassert>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+// the game sources are compiled with this header instead of the game's one
+#include "core/types.h"
+#include "core/MyMath.h"
+#include "core/SafePtr.h"
+
+// receives TRACE output of the game sources
+class ToolConsole
+{
+public:
+	void Printf(int severity, const char *fmt, ...);
+};
+ToolConsole& GetConsole();
@@ -0,0 +1,253 @@
+// mkpack.cpp
+//
+// builds a game data archive from a directory tree
+//
+// usage: mkpack [-store] <source directory> <archive.pak>
+//
+// the game shows the archive in the directory with the same name, for example
+// 'mkpack data/textures data/textures.pak' packs all textures. loose files
+// left in the directory take precedence, so the packed ones may be deleted.
+/////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <zlib.h>
+
+#include "../../game/src/tank/fs/PackFormat.h"
+
+//----------------------------------------------------
+
+struct Item
+{
+	std::string path;   // relative to the source directory with '/' delimiters
+	PackEntry   entry;
+};
+
+static bool g_store = false; // do not compress anything
+
+//----------------------------------------------------
+
+static void Scan(const std::string &root, const std::string &rel, std::vector<Item> &items)
+{
+	std::string dir = rel.empty() ? root : root + "/" + rel;
+
+#ifdef _WIN32
+	WIN32_FIND_DATA fd;
+	HANDLE search = FindFirstFile((dir + "\\*").c_str(), &fd);
+	if( INVALID_HANDLE_VALUE == search )
+		return;
+	do
+	{
+		std::string name = fd.cFileName;
+		bool isDir = 0 != (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	DIR *search = opendir(dir.c_str());
+	if( !search )
+		return;
+	while( struct dirent *de = readdir(search) )
+	{
+		std::string name = de->d_name;
+		struct stat st;
+		if( stat((dir + "/" + name).c_str(), &st) )
+			continue;
+		bool isDir = S_ISDIR(st.st_mode);
+#endif
+		if( "." == name || ".." == name || ".svn" == name )
+			continue;
+
+		std::string path = rel.empty() ? name : rel + "/" + name;
+		if( isDir )
+		{
+			Scan(root, path, items);
+		}
+		else
+		{
+			Item item;
+			item.path = path;
+			memset(&item.entry, 0, sizeof(PackEntry));
+			items.push_back(item);
+		}
+#ifdef _WIN32
+	} while( FindNextFile(search, &fd) );
+	FindClose(search);
+#else
+	}
+	closedir(search);
+#endif
+}
+
+static bool LoadFile(const std::string &fileName, std::vector<char> &data)
+{
+	FILE *f = fopen(fileName.c_str(), "rb");
+	if( !f )
+		return false;
+	fseek(f, 0, SEEK_END);
+	data.resize(ftell(f));
+	fseek(f, 0, SEEK_SET);
+	bool ok = data.empty() || 1 == fread(&data[0], data.size(), 1, f);
+	fclose(f);
+	return ok;
+}
+
+static bool Pad(FILE *f, unsigned long &offset)
+{
+	static const char zeros[PACK_ALIGNMENT] = {0};
+	unsigned long pad = (PACK_ALIGNMENT - offset % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+	offset += pad;
+	return 0 == pad || 1 == fwrite(zeros, pad, 1, f);
+}
+
+//----------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	int arg = 1;
+	if( arg < argc && 0 == strcmp(argv[arg], "-store") )
+	{
+		g_store = true;
+		++arg;
+	}
+
+	if( argc - arg != 2 )
+	{
+		printf("usage: mkpack [-store] <source directory> <archive.pak>\n");
+		return 1;
+	}
+
+	std::string root = argv[arg];
+	std::vector<Item> items;
+	Scan(root, std::string(), items);
+
+	PackHeader header;
+	memcpy(header.signature, PACK_SIGNATURE, 4);
+	header.version = PACK_VERSION;
+	header.entryCount = (unsigned int) items.size();
+	header.bucketCount = 1;
+	while( header.bucketCount < header.entryCount * 2 )
+		header.bucketCount *= 2;
+
+	// name table and hash chains
+	std::vector<char> names;
+	std::vector<unsigned int> buckets(header.bucketCount, PACK_NO_ENTRY);
+	for( size_t i = 0; i < items.size(); ++i )
+	{
+		PackEntry &e = items[i].entry;
+		e.hash = PackHashPath(items[i].path.c_str());
+		e.nameOffset = (unsigned int) names.size();
+		names.insert(names.end(), items[i].path.begin(), items[i].path.end());
+		names.push_back('\0');
+
+		unsigned int &bucket = buckets[e.hash & (header.bucketCount - 1)];
+		e.next = bucket;
+		bucket = (unsigned int) i;
+	}
+	if( names.empty() )
+		names.push_back('\0');
+	header.namesSize = (unsigned int) names.size();
+
+	FILE *out = fopen(argv[arg + 1], "wb");
+	if( !out )
+	{
+		printf("could not create '%s'\n", argv[arg + 1]);
+		return 1;
+	}
+
+	// the directory is written twice: now to reserve space and at the end with the offsets filled in
+	unsigned long offset = sizeof(PackHeader) + header.bucketCount * sizeof(unsigned int)
+		+ header.entryCount * sizeof(PackEntry) + header.namesSize;
+	fseek(out, offset, SEEK_SET);
+
+	unsigned long totalOriginal = 0;
+	unsigned long totalStored = 0;
+
+	for( size_t i = 0; i < items.size(); ++i )
+	{
+		PackEntry &e = items[i].entry;
+
+		std::vector<char> data;
+		if( !LoadFile(root + "/" + items[i].path, data) )
+		{
+			printf("could not read '%s'\n", items[i].path.c_str());
+			fclose(out);
+			return 1;
+		}
+
+		// keep the data compressed only if it saves at least one page
+		std::vector<char> packed;
+		if( !g_store && data.size() > PACK_ALIGNMENT )
+		{
+			uLongf packedSize = compressBound((uLong) data.size());
+			packed.resize(packedSize);
+			if( Z_OK == compress2((Bytef *) &packed[0], &packedSize,
+			                      (const Bytef *) &data[0], (uLong) data.size(), Z_BEST_COMPRESSION)
+			    && packedSize + PACK_ALIGNMENT <= data.size() )
+			{
+				packed.resize(packedSize);
+			}
+			else
+			{
+				packed.clear();
+			}
+		}
+
+		const std::vector<char> &stored = packed.empty() ? data : packed;
+		e.flags = packed.empty() ? 0 : PACK_COMPRESSED;
+		e.originalSize = (unsigned int) data.size();
+		e.storedSize = (unsigned int) stored.size();
+
+		if( !Pad(out, offset) )
+		{
+			printf("write error\n");
+			fclose(out);
+			return 1;
+		}
+		e.dataOffset = (unsigned int) offset;
+		if( !stored.empty() && 1 != fwrite(&stored[0], stored.size(), 1, out) )
+		{
+			printf("write error\n");
+			fclose(out);
+			return 1;
+		}
+		offset += (unsigned long) stored.size();
+
+		totalOriginal += e.originalSize;
+		totalStored += e.storedSize;
+		printf("%-48s %9u %9u%s\n", items[i].path.c_str(), e.originalSize, e.storedSize,
+			(e.flags & PACK_COMPRESSED) ? " z" : "");
+	}
+
+	// directory
+	fseek(out, 0, SEEK_SET);
+	bool ok = 1 == fwrite(&header, sizeof(PackHeader), 1, out)
+		&& 1 == fwrite(&buckets[0], buckets.size() * sizeof(unsigned int), 1, out);
+	for( size_t i = 0; ok && i < items.size(); ++i )
+	{
+		ok = 1 == fwrite(&items[i].entry, sizeof(PackEntry), 1, out);
+	}
+	ok = ok && 1 == fwrite(&names[0], names.size(), 1, out);
+	fclose(out);
+
+	if( !ok )
+	{
+		printf("write error\n");
+		return 1;
+	}
+
+	printf("%u files, %lu -> %lu bytes, archive size %lu\n",
+		header.entryCount, totalOriginal, totalStored, offset);
+	return 0;
+}
+
+// end of file